@@ -40,6 +40,7 @@ service::ResolverMap FolderAdded::getResolvers() const noexcept
 	return {
 		{ R"gql(added)gql"sv, [this](service::ResolverParams&& params) { return resolveAdded(std::move(params)); } },
 		{ R"gql(index)gql"sv, [this](service::ResolverParams&& params) { return resolveIndex(std::move(params)); } },
+		{ R"gql(sequence)gql"sv, [this](service::ResolverParams&& params) { return resolveSequence(std::move(params)); } },
 		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
 	};
 }
@@ -74,6 +75,16 @@ service::AwaitableResolver FolderAdded::resolveAdded(service::ResolverParams&& p
 	return service::ModifiedResult<Folder>::convert(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver FolderAdded::resolveSequence(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getSequence(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver FolderAdded::resolve_typename(service::ResolverParams&& params) const
 {
 	return service::Result<std::string>::convert(std::string{ R"gql(FolderAdded)gql" }, std::move(params));
@@ -85,7 +96,8 @@ void AddFolderAddedDetails(const std::shared_ptr<schema::ObjectType>& typeFolder
 {
 	typeFolderAdded->AddFields({
 		schema::Field::Make(R"gql(index)gql"sv, R"md(Index in the subscribed window)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv))),
-		schema::Field::Make(R"gql(added)gql"sv, R"md(`Folder` that was added)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv)))
+		schema::Field::Make(R"gql(added)gql"sv, R"md(`Folder` that was added)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv))),
+		schema::Field::Make(R"gql(sequence)gql"sv, R"md(Position of this change in the history of the subscribed window, which can be passed to `@resume`)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)))
 	});
 }
 
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// WARNING! Do not edit this file manually, your changes will be overwritten.
+
+#include "FolderCountsObject.h"
+
+#include "graphqlservice/internal/Schema.h"
+
+#include "graphqlservice/introspection/IntrospectionSchema.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std::literals;
+
+namespace graphql::mapi {
+namespace object {
+
+FolderCounts::FolderCounts(std::unique_ptr<const Concept>&& pimpl) noexcept
+	: service::Object{ getTypeNames(), getResolvers() }
+	, _pimpl { std::move(pimpl) }
+{
+}
+
+service::TypeNames FolderCounts::getTypeNames() const noexcept
+{
+	return {
+		R"gql(FolderCounts)gql"sv
+	};
+}
+
+service::ResolverMap FolderCounts::getResolvers() const noexcept
+{
+	return {
+		{ R"gql(count)gql"sv, [this](service::ResolverParams&& params) { return resolveCount(std::move(params)); } },
+		{ R"gql(unread)gql"sv, [this](service::ResolverParams&& params) { return resolveUnread(std::move(params)); } },
+		{ R"gql(storeId)gql"sv, [this](service::ResolverParams&& params) { return resolveStoreId(std::move(params)); } },
+		{ R"gql(folderId)gql"sv, [this](service::ResolverParams&& params) { return resolveFolderId(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+	};
+}
+
+void FolderCounts::beginSelectionSet(const service::SelectionSetParams& params) const
+{
+	_pimpl->beginSelectionSet(params);
+}
+
+void FolderCounts::endSelectionSet(const service::SelectionSetParams& params) const
+{
+	_pimpl->endSelectionSet(params);
+}
+
+service::AwaitableResolver FolderCounts::resolveStoreId(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getStoreId(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<response::IdType>::convert(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver FolderCounts::resolveFolderId(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getFolderId(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<response::IdType>::convert(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver FolderCounts::resolveCount(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getCount(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver FolderCounts::resolveUnread(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getUnread(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver FolderCounts::resolve_typename(service::ResolverParams&& params) const
+{
+	return service::Result<std::string>::convert(std::string{ R"gql(FolderCounts)gql" }, std::move(params));
+}
+
+} // namespace object
+
+void AddFolderCountsDetails(const std::shared_ptr<schema::ObjectType>& typeFolderCounts, const std::shared_ptr<schema::Schema>& schema)
+{
+	typeFolderCounts->AddFields({
+		schema::Field::Make(R"gql(storeId)gql"sv, R"md(ID of the store containing the folder)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv))),
+		schema::Field::Make(R"gql(folderId)gql"sv, R"md(ID of the folder)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv))),
+		schema::Field::Make(R"gql(count)gql"sv, R"md(Total item count)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv))),
+		schema::Field::Make(R"gql(unread)gql"sv, R"md(Unread item count)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)))
+	});
+}
+
+} // namespace graphql::mapi
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// WARNING! Do not edit this file manually, your changes will be overwritten.
+
+#pragma once
+
+#ifndef FOLDERCOUNTSOBJECT_H
+#define FOLDERCOUNTSOBJECT_H
+
+#include "MAPISchema.h"
+
+namespace graphql::mapi::object {
+namespace methods::FolderCountsHas {
+
+template <class TImpl>
+concept getStoreIdWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<response::IdType> { impl.getStoreId(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getStoreId = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<response::IdType> { impl.getStoreId() } };
+};
+
+template <class TImpl>
+concept getFolderIdWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<response::IdType> { impl.getFolderId(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getFolderId = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<response::IdType> { impl.getFolderId() } };
+};
+
+template <class TImpl>
+concept getCountWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<int> { impl.getCount(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getCount = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<int> { impl.getCount() } };
+};
+
+template <class TImpl>
+concept getUnreadWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<int> { impl.getUnread(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getUnread = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<int> { impl.getUnread() } };
+};
+
+template <class TImpl>
+concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
+{
+	{ impl.beginSelectionSet(params) };
+};
+
+template <class TImpl>
+concept endSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
+{
+	{ impl.endSelectionSet(params) };
+};
+
+} // namespace methods::FolderCountsHas
+
+class [[nodiscard]] FolderCounts final
+	: public service::Object
+{
+private:
+	[[nodiscard]] service::AwaitableResolver resolveStoreId(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveFolderId(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveCount(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveUnread(service::ResolverParams&& params) const;
+
+	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
+
+	struct [[nodiscard]] Concept
+	{
+		virtual ~Concept() = default;
+
+		virtual void beginSelectionSet(const service::SelectionSetParams& params) const = 0;
+		virtual void endSelectionSet(const service::SelectionSetParams& params) const = 0;
+
+		[[nodiscard]] virtual service::AwaitableScalar<response::IdType> getStoreId(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<response::IdType> getFolderId(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<int> getCount(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<int> getUnread(service::FieldParams&& params) const = 0;
+	};
+
+	template <class T>
+	struct [[nodiscard]] Model
+		: Concept
+	{
+		Model(std::shared_ptr<T>&& pimpl) noexcept
+			: _pimpl { std::move(pimpl) }
+		{
+		}
+
+		[[nodiscard]] service::AwaitableScalar<response::IdType> getStoreId(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::getStoreIdWithParams<T>)
+			{
+				return { _pimpl->getStoreId(std::move(params)) };
+			}
+			else if constexpr (methods::FolderCountsHas::getStoreId<T>)
+			{
+				return { _pimpl->getStoreId() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderCounts::getStoreId is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableScalar<response::IdType> getFolderId(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::getFolderIdWithParams<T>)
+			{
+				return { _pimpl->getFolderId(std::move(params)) };
+			}
+			else if constexpr (methods::FolderCountsHas::getFolderId<T>)
+			{
+				return { _pimpl->getFolderId() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderCounts::getFolderId is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableScalar<int> getCount(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::getCountWithParams<T>)
+			{
+				return { _pimpl->getCount(std::move(params)) };
+			}
+			else if constexpr (methods::FolderCountsHas::getCount<T>)
+			{
+				return { _pimpl->getCount() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderCounts::getCount is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableScalar<int> getUnread(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::getUnreadWithParams<T>)
+			{
+				return { _pimpl->getUnread(std::move(params)) };
+			}
+			else if constexpr (methods::FolderCountsHas::getUnread<T>)
+			{
+				return { _pimpl->getUnread() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderCounts::getUnread is not implemented)ex");
+			}
+		}
+
+		void beginSelectionSet(const service::SelectionSetParams& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::beginSelectionSet<T>)
+			{
+				_pimpl->beginSelectionSet(params);
+			}
+		}
+
+		void endSelectionSet(const service::SelectionSetParams& params) const final
+		{
+			if constexpr (methods::FolderCountsHas::endSelectionSet<T>)
+			{
+				_pimpl->endSelectionSet(params);
+			}
+		}
+
+	private:
+		const std::shared_ptr<T> _pimpl;
+	};
+
+	FolderCounts(std::unique_ptr<const Concept>&& pimpl) noexcept;
+
+	[[nodiscard]] service::TypeNames getTypeNames() const noexcept;
+	[[nodiscard]] service::ResolverMap getResolvers() const noexcept;
+
+	void beginSelectionSet(const service::SelectionSetParams& params) const final;
+	void endSelectionSet(const service::SelectionSetParams& params) const final;
+
+	const std::unique_ptr<const Concept> _pimpl;
+
+public:
+	template <class T>
+	FolderCounts(std::shared_ptr<T> pimpl) noexcept
+		: FolderCounts { std::unique_ptr<const Concept> { std::make_unique<Model<T>>(std::move(pimpl)) } }
+	{
+	}
+
+	[[nodiscard]] static constexpr std::string_view getObjectType() noexcept
+	{
+		return { R"gql(FolderCounts)gql" };
+	}
+};
+
+} // namespace graphql::mapi::object
+
+#endif // FOLDERCOUNTSOBJECT_H
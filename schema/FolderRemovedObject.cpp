@@ -39,6 +39,7 @@ service::ResolverMap FolderRemoved::getResolvers() const noexcept
 	return {
 		{ R"gql(index)gql"sv, [this](service::ResolverParams&& params) { return resolveIndex(std::move(params)); } },
 		{ R"gql(removed)gql"sv, [this](service::ResolverParams&& params) { return resolveRemoved(std::move(params)); } },
+		{ R"gql(sequence)gql"sv, [this](service::ResolverParams&& params) { return resolveSequence(std::move(params)); } },
 		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
 	};
 }
@@ -73,6 +74,16 @@ service::AwaitableResolver FolderRemoved::resolveRemoved(service::ResolverParams
 	return service::ModifiedResult<response::IdType>::convert(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver FolderRemoved::resolveSequence(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getSequence(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver FolderRemoved::resolve_typename(service::ResolverParams&& params) const
 {
 	return service::Result<std::string>::convert(std::string{ R"gql(FolderRemoved)gql" }, std::move(params));
@@ -84,7 +95,8 @@ void AddFolderRemovedDetails(const std::shared_ptr<schema::ObjectType>& typeFold
 {
 	typeFolderRemoved->AddFields({
 		schema::Field::Make(R"gql(index)gql"sv, R"md(Index in the subscribed window)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv))),
-		schema::Field::Make(R"gql(removed)gql"sv, R"md(ID of the `Folder` that was removed)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv)))
+		schema::Field::Make(R"gql(removed)gql"sv, R"md(ID of the `Folder` that was removed)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv))),
+		schema::Field::Make(R"gql(sequence)gql"sv, R"md(Position of this change in the history of the subscribed window, which can be passed to `@resume`)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)))
 	});
 }
 
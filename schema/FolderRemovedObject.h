@@ -44,6 +44,18 @@ concept getRemoved = requires (TImpl impl)
 	{ service::AwaitableScalar<response::IdType> { impl.getRemoved() } };
 };
 
+template <class TImpl>
+concept getSequenceWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getSequence = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence() } };
+};
+
 template <class TImpl>
 concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
 {
@@ -64,6 +76,7 @@ class [[nodiscard]] FolderRemoved final
 private:
 	[[nodiscard]] service::AwaitableResolver resolveIndex(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveRemoved(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveSequence(service::ResolverParams&& params) const;
 
 	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
 
@@ -76,6 +89,7 @@ private:
 
 		[[nodiscard]] virtual service::AwaitableScalar<int> getIndex(service::FieldParams&& params) const = 0;
 		[[nodiscard]] virtual service::AwaitableScalar<response::IdType> getRemoved(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const = 0;
 	};
 
 	template <class T>
@@ -119,6 +133,22 @@ private:
 			}
 		}
 
+		[[nodiscard]] service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderRemovedHas::getSequenceWithParams<T>)
+			{
+				return { _pimpl->getSequence(std::move(params)) };
+			}
+			else if constexpr (methods::FolderRemovedHas::getSequence<T>)
+			{
+				return { _pimpl->getSequence() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderRemoved::getSequence is not implemented)ex");
+			}
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const final
 		{
 			if constexpr (methods::FolderRemovedHas::beginSelectionSet<T>)
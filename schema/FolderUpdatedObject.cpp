@@ -5,6 +5,7 @@
 
 #include "FolderUpdatedObject.h"
 #include "FolderObject.h"
+#include "PropertyObject.h"
 
 #include "graphqlservice/internal/Schema.h"
 
@@ -40,7 +41,9 @@ service::ResolverMap FolderUpdated::getResolvers() const noexcept
 	return {
 		{ R"gql(index)gql"sv, [this](service::ResolverParams&& params) { return resolveIndex(std::move(params)); } },
 		{ R"gql(updated)gql"sv, [this](service::ResolverParams&& params) { return resolveUpdated(std::move(params)); } },
-		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
+		{ R"gql(sequence)gql"sv, [this](service::ResolverParams&& params) { return resolveSequence(std::move(params)); } },
+		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
+		{ R"gql(changedFields)gql"sv, [this](service::ResolverParams&& params) { return resolveChangedFields(std::move(params)); } }
 	};
 }
 
@@ -74,6 +77,26 @@ service::AwaitableResolver FolderUpdated::resolveUpdated(service::ResolverParams
 	return service::ModifiedResult<Folder>::convert(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver FolderUpdated::resolveChangedFields(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getChangedFields(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<Property>::convert<service::TypeModifier::Nullable, service::TypeModifier::List>(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver FolderUpdated::resolveSequence(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getSequence(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver FolderUpdated::resolve_typename(service::ResolverParams&& params) const
 {
 	return service::Result<std::string>::convert(std::string{ R"gql(FolderUpdated)gql" }, std::move(params));
@@ -85,7 +108,9 @@ void AddFolderUpdatedDetails(const std::shared_ptr<schema::ObjectType>& typeFold
 {
 	typeFolderUpdated->AddFields({
 		schema::Field::Make(R"gql(index)gql"sv, R"md(Index in the subscribed window)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv))),
-		schema::Field::Make(R"gql(updated)gql"sv, R"md(`Folder` that was updated)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv)))
+		schema::Field::Make(R"gql(updated)gql"sv, R"md(`Folder` that was updated)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv))),
+		schema::Field::Make(R"gql(changedFields)gql"sv, R"md(Columns which changed since the previous version of the `Folder`, or `null` if the previous version was not in the subscribed window)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Property)gql"sv)))),
+		schema::Field::Make(R"gql(sequence)gql"sv, R"md(Position of this change in the history of the subscribed window, which can be passed to `@resume`)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)))
 	});
 }
 
@@ -44,6 +44,30 @@ concept getUpdated = requires (TImpl impl)
 	{ service::AwaitableObject<std::shared_ptr<Folder>> { impl.getUpdated() } };
 };
 
+template <class TImpl>
+concept getChangedFieldsWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Property>>>> { impl.getChangedFields(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getChangedFields = requires (TImpl impl)
+{
+	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Property>>>> { impl.getChangedFields() } };
+};
+
+template <class TImpl>
+concept getSequenceWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getSequence = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence() } };
+};
+
 template <class TImpl>
 concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
 {
@@ -64,6 +88,8 @@ class [[nodiscard]] FolderUpdated final
 private:
 	[[nodiscard]] service::AwaitableResolver resolveIndex(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveUpdated(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveChangedFields(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveSequence(service::ResolverParams&& params) const;
 
 	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
 
@@ -76,6 +102,8 @@ private:
 
 		[[nodiscard]] virtual service::AwaitableScalar<int> getIndex(service::FieldParams&& params) const = 0;
 		[[nodiscard]] virtual service::AwaitableObject<std::shared_ptr<Folder>> getUpdated(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Property>>>> getChangedFields(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const = 0;
 	};
 
 	template <class T>
@@ -119,6 +147,38 @@ private:
 			}
 		}
 
+		[[nodiscard]] service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Property>>>> getChangedFields(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderUpdatedHas::getChangedFieldsWithParams<T>)
+			{
+				return { _pimpl->getChangedFields(std::move(params)) };
+			}
+			else if constexpr (methods::FolderUpdatedHas::getChangedFields<T>)
+			{
+				return { _pimpl->getChangedFields() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderUpdated::getChangedFields is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FolderUpdatedHas::getSequenceWithParams<T>)
+			{
+				return { _pimpl->getSequence(std::move(params)) };
+			}
+			else if constexpr (methods::FolderUpdatedHas::getSequence<T>)
+			{
+				return { _pimpl->getSequence() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FolderUpdated::getSequence is not implemented)ex");
+			}
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const final
 		{
 			if constexpr (methods::FolderUpdatedHas::beginSelectionSet<T>)
@@ -39,6 +39,7 @@ service::ResolverMap FoldersReloaded::getResolvers() const noexcept
 {
 	return {
 		{ R"gql(reloaded)gql"sv, [this](service::ResolverParams&& params) { return resolveReloaded(std::move(params)); } },
+		{ R"gql(sequence)gql"sv, [this](service::ResolverParams&& params) { return resolveSequence(std::move(params)); } },
 		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } }
 	};
 }
@@ -63,6 +64,16 @@ service::AwaitableResolver FoldersReloaded::resolveReloaded(service::ResolverPar
 	return service::ModifiedResult<Folder>::convert<service::TypeModifier::List>(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver FoldersReloaded::resolveSequence(service::ResolverParams&& params) const
+{
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getSequence(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<int>::convert(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver FoldersReloaded::resolve_typename(service::ResolverParams&& params) const
 {
 	return service::Result<std::string>::convert(std::string{ R"gql(FoldersReloaded)gql" }, std::move(params));
@@ -73,7 +84,8 @@ service::AwaitableResolver FoldersReloaded::resolve_typename(service::ResolverPa
 void AddFoldersReloadedDetails(const std::shared_ptr<schema::ObjectType>& typeFoldersReloaded, const std::shared_ptr<schema::Schema>& schema)
 {
 	typeFoldersReloaded->AddFields({
-		schema::Field::Make(R"gql(reloaded)gql"sv, R"md(`Folders` that were reloaded)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv)))))
+		schema::Field::Make(R"gql(reloaded)gql"sv, R"md(`Folders` that were reloaded)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv))))),
+		schema::Field::Make(R"gql(sequence)gql"sv, R"md(Position of this change in the history of the subscribed window, which can be passed to `@resume`)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)))
 	});
 }
 
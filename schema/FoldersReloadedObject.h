@@ -32,6 +32,18 @@ concept getReloaded = requires (TImpl impl)
 	{ service::AwaitableObject<std::vector<std::shared_ptr<Folder>>> { impl.getReloaded() } };
 };
 
+template <class TImpl>
+concept getSequenceWithParams = requires (TImpl impl, service::FieldParams params)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence(std::move(params)) } };
+};
+
+template <class TImpl>
+concept getSequence = requires (TImpl impl)
+{
+	{ service::AwaitableScalar<int> { impl.getSequence() } };
+};
+
 template <class TImpl>
 concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
 {
@@ -51,6 +63,7 @@ class [[nodiscard]] FoldersReloaded final
 {
 private:
 	[[nodiscard]] service::AwaitableResolver resolveReloaded(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveSequence(service::ResolverParams&& params) const;
 
 	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
 
@@ -62,6 +75,7 @@ private:
 		virtual void endSelectionSet(const service::SelectionSetParams& params) const = 0;
 
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<Folder>>> getReloaded(service::FieldParams&& params) const = 0;
+		[[nodiscard]] virtual service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const = 0;
 	};
 
 	template <class T>
@@ -89,6 +103,22 @@ private:
 			}
 		}
 
+		[[nodiscard]] service::AwaitableScalar<int> getSequence(service::FieldParams&& params) const final
+		{
+			if constexpr (methods::FoldersReloadedHas::getSequenceWithParams<T>)
+			{
+				return { _pimpl->getSequence(std::move(params)) };
+			}
+			else if constexpr (methods::FoldersReloadedHas::getSequence<T>)
+			{
+				return { _pimpl->getSequence() };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(FoldersReloaded::getSequence is not implemented)ex");
+			}
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const final
 		{
 			if constexpr (methods::FoldersReloadedHas::beginSelectionSet<T>)
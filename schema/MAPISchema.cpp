@@ -994,6 +994,8 @@ void AddTypesToSchema(const std::shared_ptr<schema::Schema>& schema)
 	schema->AddType(R"gql(FolderRemoved)gql"sv, typeFolderRemoved);
 	auto typeFoldersReloaded = schema::ObjectType::Make(R"gql(FoldersReloaded)gql"sv, R"md(Payload for subscription events when all of the `Folder` rows have been reloaded)md"sv);
 	schema->AddType(R"gql(FoldersReloaded)gql"sv, typeFoldersReloaded);
+	auto typeFolderCounts = schema::ObjectType::Make(R"gql(FolderCounts)gql"sv, R"md(Payload for `folderCounts` subscription events with the latest counts of a `Folder`)md"sv);
+	schema->AddType(R"gql(FolderCounts)gql"sv, typeFolderCounts);
 
 	typeSpecialFolder->AddEnumValues({
 		{ service::s_namesSpecialFolder[static_cast<size_t>(mapi::SpecialFolder::INBOX)], R"md(Default delivery location for new mail items)md"sv, std::nullopt },
@@ -1118,6 +1120,7 @@ void AddTypesToSchema(const std::shared_ptr<schema::Schema>& schema)
 	AddFolderUpdatedDetails(typeFolderUpdated, schema);
 	AddFolderRemovedDetails(typeFolderRemoved, schema);
 	AddFoldersReloadedDetails(typeFoldersReloaded, schema);
+	AddFolderCountsDetails(typeFolderCounts, schema);
 
 	schema->AddDirective(schema::Directive::Make(R"gql(orderBy)gql"sv, R"md(Sort the results of any object collection by the values of these properties.)md"sv, {
 		introspection::DirectiveLocation::FIELD
@@ -1144,6 +1147,11 @@ void AddTypesToSchema(const std::shared_ptr<schema::Schema>& schema)
 	}, {
 		schema::InputValue::Make(R"gql(count)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)), R"gql()gql"sv)
 	}, false));
+	schema->AddDirective(schema::Directive::Make(R"gql(resume)gql"sv, R"md(Resume a subscription after the last `sequence` it received. The changes it missed are delivered first, or a `Reloaded` payload if they are no longer available. Sequences count up from 1 to the largest `Int` and then wrap back around to 1. Skip any change whose `sequence` was already applied.)md"sv, {
+		introspection::DirectiveLocation::FIELD
+	}, {
+		schema::InputValue::Make(R"gql(sequence)gql"sv, R"md()md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Int)gql"sv)), R"gql()gql"sv)
+	}, false));
 
 	schema->AddQueryType(typeQuery);
 	schema->AddMutationType(typeMutation);
@@ -367,6 +367,7 @@ class FolderAdded;
 class FolderUpdated;
 class FolderRemoved;
 class FoldersReloaded;
+class FolderCounts;
 
 } // namespace object
 
@@ -426,6 +427,7 @@ void AddFolderAddedDetails(const std::shared_ptr<schema::ObjectType>& typeFolder
 void AddFolderUpdatedDetails(const std::shared_ptr<schema::ObjectType>& typeFolderUpdated, const std::shared_ptr<schema::Schema>& schema);
 void AddFolderRemovedDetails(const std::shared_ptr<schema::ObjectType>& typeFolderRemoved, const std::shared_ptr<schema::Schema>& schema);
 void AddFoldersReloadedDetails(const std::shared_ptr<schema::ObjectType>& typeFoldersReloaded, const std::shared_ptr<schema::Schema>& schema);
+void AddFolderCountsDetails(const std::shared_ptr<schema::ObjectType>& typeFolderCounts, const std::shared_ptr<schema::Schema>& schema);
 
 std::shared_ptr<schema::Schema> GetSchema();
 
@@ -46,7 +46,9 @@ service::ResolverMap Store::getResolvers() const noexcept
 		{ R"gql(itemProperties)gql"sv, [this](service::ResolverParams&& params) { return resolveItemProperties(std::move(params)); } },
 		{ R"gql(specialFolders)gql"sv, [this](service::ResolverParams&& params) { return resolveSpecialFolders(std::move(params)); } },
 		{ R"gql(folderHierarchy)gql"sv, [this](service::ResolverParams&& params) { return resolveFolderHierarchy(std::move(params)); } },
-		{ R"gql(folderProperties)gql"sv, [this](service::ResolverParams&& params) { return resolveFolderProperties(std::move(params)); } }
+		{ R"gql(itemsProperties)gql"sv, [this](service::ResolverParams&& params) { return resolveItemsProperties(std::move(params)); } },
+		{ R"gql(folderProperties)gql"sv, [this](service::ResolverParams&& params) { return resolveFolderProperties(std::move(params)); } },
+		{ R"gql(foldersProperties)gql"sv, [this](service::ResolverParams&& params) { return resolveFoldersProperties(std::move(params)); } }
 	};
 }
 
@@ -136,13 +138,40 @@ service::AwaitableResolver Store::resolveItemProperties(service::ResolverParams&
 	return service::ModifiedResult<Property>::convert<service::TypeModifier::List, service::TypeModifier::Nullable>(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver Store::resolveFoldersProperties(service::ResolverParams&& params) const
+{
+	auto argFolderIds = service::ModifiedArgument<response::IdType>::require<service::TypeModifier::List>("folderIds", params.arguments);
+	auto argIds = service::ModifiedArgument<mapi::Column>::require<service::TypeModifier::Nullable, service::TypeModifier::List>("ids", params.arguments);
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getFoldersProperties(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)), std::move(argFolderIds), std::move(argIds));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<Property>::convert<service::TypeModifier::List, service::TypeModifier::Nullable, service::TypeModifier::List, service::TypeModifier::Nullable>(std::move(result), std::move(params));
+}
+
+service::AwaitableResolver Store::resolveItemsProperties(service::ResolverParams&& params) const
+{
+	auto argFolderId = service::ModifiedArgument<response::IdType>::require<service::TypeModifier::Nullable>("folderId", params.arguments);
+	auto argItemIds = service::ModifiedArgument<response::IdType>::require<service::TypeModifier::List>("itemIds", params.arguments);
+	auto argIds = service::ModifiedArgument<mapi::Column>::require<service::TypeModifier::Nullable, service::TypeModifier::List>("ids", params.arguments);
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getItemsProperties(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)), std::move(argFolderId), std::move(argItemIds), std::move(argIds));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<Property>::convert<service::TypeModifier::List, service::TypeModifier::Nullable, service::TypeModifier::List, service::TypeModifier::Nullable>(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver Store::resolveFolderHierarchy(service::ResolverParams&& params) const
 {
 	auto argParentFolderId = service::ModifiedArgument<response::IdType>::require<service::TypeModifier::Nullable>("parentFolderId", params.arguments);
 	auto argOnlyChildren = service::ModifiedArgument<bool>::require("onlyChildren", params.arguments);
+	auto argMaxDepth = service::ModifiedArgument<int>::require<service::TypeModifier::Nullable>("maxDepth", params.arguments);
+	auto argContainerClasses = service::ModifiedArgument<std::string>::require<service::TypeModifier::Nullable, service::TypeModifier::List>("containerClasses", params.arguments);
 	std::unique_lock resolverLock(_resolverMutex);
 	auto directives = std::move(params.fieldDirectives);
-	auto result = _pimpl->getFolderHierarchy(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)), std::move(argParentFolderId), std::move(argOnlyChildren));
+	auto result = _pimpl->getFolderHierarchy(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)), std::move(argParentFolderId), std::move(argOnlyChildren), std::move(argMaxDepth), std::move(argContainerClasses));
 	resolverLock.unlock();
 
 	return service::ModifiedResult<Folder>::convert<service::TypeModifier::Nullable, service::TypeModifier::List>(std::move(result), std::move(params));
@@ -175,9 +204,20 @@ void AddStoreDetails(const std::shared_ptr<schema::ObjectType>& typeStore, const
 			schema::InputValue::Make(R"gql(itemId)gql"sv, R"md(Item ID)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv)), R"gql()gql"sv),
 			schema::InputValue::Make(R"gql(ids)gql"sv, R"md(Optional list of property IDs, returns all properties if `null`)md"sv, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Column)gql"sv))), R"gql()gql"sv)
 		}),
-		schema::Field::Make(R"gql(folderHierarchy)gql"sv, R"md(List of all folders in the store, optionally rooted at the given folder)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv))), {
+		schema::Field::Make(R"gql(foldersProperties)gql"sv, R"md(Open several folders and read any or all of their properties. Each list matches the folder ID in the same position, or is `null` if the folder could not be opened.)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::LIST, schema->LookupType(R"gql(Property)gql"sv)))), {
+			schema::InputValue::Make(R"gql(folderIds)gql"sv, R"md(Folder IDs)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv)))), R"gql()gql"sv),
+			schema::InputValue::Make(R"gql(ids)gql"sv, R"md(Optional list of property IDs, returns all properties if `null`)md"sv, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Column)gql"sv))), R"gql()gql"sv)
+		}),
+		schema::Field::Make(R"gql(itemsProperties)gql"sv, R"md(Read any or all of the properties of several items. Each list matches the item ID in the same position, or is `null` if the item could not be opened.)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::LIST, schema->LookupType(R"gql(Property)gql"sv)))), {
+			schema::InputValue::Make(R"gql(folderId)gql"sv, R"md(Optional ID of the folder which contains the items, lets it read the `ids` columns from a single restricted contents table)md"sv, schema->LookupType(R"gql(ID)gql"sv), R"gql()gql"sv),
+			schema::InputValue::Make(R"gql(itemIds)gql"sv, R"md(Item IDs)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv)))), R"gql()gql"sv),
+			schema::InputValue::Make(R"gql(ids)gql"sv, R"md(Optional list of property IDs, returns all properties if `null`)md"sv, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Column)gql"sv))), R"gql()gql"sv)
+		}),
+		schema::Field::Make(R"gql(folderHierarchy)gql"sv, R"md(List of all folders in the store, optionally rooted at the given folder. Each folder comes before its subfolders, and the subfolders of one folder all come before its next sibling (a depth-first pre-order).)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Folder)gql"sv))), {
 			schema::InputValue::Make(R"gql(parentFolderId)gql"sv, R"md(Optional id of the root folder for the traversal, uses IPM_SUBTREE if `null`)md"sv, schema->LookupType(R"gql(ID)gql"sv), R"gql()gql"sv),
-			schema::InputValue::Make(R"gql(onlyChildren)gql"sv, R"md(Whether to return only immediate children or all descendents)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Boolean)gql"sv)), R"gql()gql"sv)
+			schema::InputValue::Make(R"gql(onlyChildren)gql"sv, R"md(Whether to return only immediate children or all descendents)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(Boolean)gql"sv)), R"gql()gql"sv),
+			schema::InputValue::Make(R"gql(maxDepth)gql"sv, R"md(Optional number of levels below the root folder to return, where 1 is the same as `onlyChildren`)md"sv, schema->LookupType(R"gql(Int)gql"sv), R"gql(null)gql"sv),
+			schema::InputValue::Make(R"gql(containerClasses)gql"sv, R"md(Optional list of container classes, e.g. `IPF.Note`, only returns folders whose class starts with one of them)md"sv, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(String)gql"sv))), R"gql(null)gql"sv)
 		})
 	});
 }
@@ -98,15 +98,39 @@ concept getItemProperties = requires (TImpl impl, response::IdType itemIdArg, st
 };
 
 template <class TImpl>
-concept getFolderHierarchyWithParams = requires (TImpl impl, service::FieldParams params, std::optional<response::IdType> parentFolderIdArg, bool onlyChildrenArg)
+concept getFoldersPropertiesWithParams = requires (TImpl impl, service::FieldParams params, std::vector<response::IdType> folderIdsArg, std::optional<std::vector<Column>> idsArg)
 {
-	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> { impl.getFolderHierarchy(std::move(params), std::move(parentFolderIdArg), std::move(onlyChildrenArg)) } };
+	{ service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> { impl.getFoldersProperties(std::move(params), std::move(folderIdsArg), std::move(idsArg)) } };
 };
 
 template <class TImpl>
-concept getFolderHierarchy = requires (TImpl impl, std::optional<response::IdType> parentFolderIdArg, bool onlyChildrenArg)
+concept getFoldersProperties = requires (TImpl impl, std::vector<response::IdType> folderIdsArg, std::optional<std::vector<Column>> idsArg)
 {
-	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> { impl.getFolderHierarchy(std::move(parentFolderIdArg), std::move(onlyChildrenArg)) } };
+	{ service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> { impl.getFoldersProperties(std::move(folderIdsArg), std::move(idsArg)) } };
+};
+
+template <class TImpl>
+concept getItemsPropertiesWithParams = requires (TImpl impl, service::FieldParams params, std::optional<response::IdType> folderIdArg, std::vector<response::IdType> itemIdsArg, std::optional<std::vector<Column>> idsArg)
+{
+	{ service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> { impl.getItemsProperties(std::move(params), std::move(folderIdArg), std::move(itemIdsArg), std::move(idsArg)) } };
+};
+
+template <class TImpl>
+concept getItemsProperties = requires (TImpl impl, std::optional<response::IdType> folderIdArg, std::vector<response::IdType> itemIdsArg, std::optional<std::vector<Column>> idsArg)
+{
+	{ service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> { impl.getItemsProperties(std::move(folderIdArg), std::move(itemIdsArg), std::move(idsArg)) } };
+};
+
+template <class TImpl>
+concept getFolderHierarchyWithParams = requires (TImpl impl, service::FieldParams params, std::optional<response::IdType> parentFolderIdArg, bool onlyChildrenArg, std::optional<int> maxDepthArg, std::optional<std::vector<std::string>> containerClassesArg)
+{
+	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> { impl.getFolderHierarchy(std::move(params), std::move(parentFolderIdArg), std::move(onlyChildrenArg), std::move(maxDepthArg), std::move(containerClassesArg)) } };
+};
+
+template <class TImpl>
+concept getFolderHierarchy = requires (TImpl impl, std::optional<response::IdType> parentFolderIdArg, bool onlyChildrenArg, std::optional<int> maxDepthArg, std::optional<std::vector<std::string>> containerClassesArg)
+{
+	{ service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> { impl.getFolderHierarchy(std::move(parentFolderIdArg), std::move(onlyChildrenArg), std::move(maxDepthArg), std::move(containerClassesArg)) } };
 };
 
 template <class TImpl>
@@ -134,6 +158,8 @@ private:
 	[[nodiscard]] service::AwaitableResolver resolveSpecialFolders(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveFolderProperties(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveItemProperties(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveFoldersProperties(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveItemsProperties(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveFolderHierarchy(service::ResolverParams&& params) const;
 
 	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
@@ -152,7 +178,9 @@ private:
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<Folder>>> getSpecialFolders(service::FieldParams&& params, std::vector<SpecialFolder>&& idsArg) const = 0;
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<Property>>> getFolderProperties(service::FieldParams&& params, response::IdType&& folderIdArg, std::optional<std::vector<Column>>&& idsArg) const = 0;
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<Property>>> getItemProperties(service::FieldParams&& params, response::IdType&& itemIdArg, std::optional<std::vector<Column>>&& idsArg) const = 0;
-		[[nodiscard]] virtual service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> getFolderHierarchy(service::FieldParams&& params, std::optional<response::IdType>&& parentFolderIdArg, bool&& onlyChildrenArg) const = 0;
+		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> getFoldersProperties(service::FieldParams&& params, std::vector<response::IdType>&& folderIdsArg, std::optional<std::vector<Column>>&& idsArg) const = 0;
+		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> getItemsProperties(service::FieldParams&& params, std::optional<response::IdType>&& folderIdArg, std::vector<response::IdType>&& itemIdsArg, std::optional<std::vector<Column>>&& idsArg) const = 0;
+		[[nodiscard]] virtual service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> getFolderHierarchy(service::FieldParams&& params, std::optional<response::IdType>&& parentFolderIdArg, bool&& onlyChildrenArg, std::optional<int>&& maxDepthArg, std::optional<std::vector<std::string>>&& containerClassesArg) const = 0;
 	};
 
 	template <class T>
@@ -276,15 +304,47 @@ private:
 			}
 		}
 
-		[[nodiscard]] service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> getFolderHierarchy(service::FieldParams&& params, std::optional<response::IdType>&& parentFolderIdArg, bool&& onlyChildrenArg) const final
+		[[nodiscard]] service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> getFoldersProperties(service::FieldParams&& params, std::vector<response::IdType>&& folderIdsArg, std::optional<std::vector<Column>>&& idsArg) const final
+		{
+			if constexpr (methods::StoreHas::getFoldersPropertiesWithParams<T>)
+			{
+				return { _pimpl->getFoldersProperties(std::move(params), std::move(folderIdsArg), std::move(idsArg)) };
+			}
+			else if constexpr (methods::StoreHas::getFoldersProperties<T>)
+			{
+				return { _pimpl->getFoldersProperties(std::move(folderIdsArg), std::move(idsArg)) };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(Store::getFoldersProperties is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableObject<std::vector<std::optional<std::vector<std::shared_ptr<Property>>>>> getItemsProperties(service::FieldParams&& params, std::optional<response::IdType>&& folderIdArg, std::vector<response::IdType>&& itemIdsArg, std::optional<std::vector<Column>>&& idsArg) const final
+		{
+			if constexpr (methods::StoreHas::getItemsPropertiesWithParams<T>)
+			{
+				return { _pimpl->getItemsProperties(std::move(params), std::move(folderIdArg), std::move(itemIdsArg), std::move(idsArg)) };
+			}
+			else if constexpr (methods::StoreHas::getItemsProperties<T>)
+			{
+				return { _pimpl->getItemsProperties(std::move(folderIdArg), std::move(itemIdsArg), std::move(idsArg)) };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(Store::getItemsProperties is not implemented)ex");
+			}
+		}
+
+		[[nodiscard]] service::AwaitableObject<std::optional<std::vector<std::shared_ptr<Folder>>>> getFolderHierarchy(service::FieldParams&& params, std::optional<response::IdType>&& parentFolderIdArg, bool&& onlyChildrenArg, std::optional<int>&& maxDepthArg, std::optional<std::vector<std::string>>&& containerClassesArg) const final
 		{
 			if constexpr (methods::StoreHas::getFolderHierarchyWithParams<T>)
 			{
-				return { _pimpl->getFolderHierarchy(std::move(params), std::move(parentFolderIdArg), std::move(onlyChildrenArg)) };
+				return { _pimpl->getFolderHierarchy(std::move(params), std::move(parentFolderIdArg), std::move(onlyChildrenArg), std::move(maxDepthArg), std::move(containerClassesArg)) };
 			}
 			else if constexpr (methods::StoreHas::getFolderHierarchy<T>)
 			{
-				return { _pimpl->getFolderHierarchy(std::move(parentFolderIdArg), std::move(onlyChildrenArg)) };
+				return { _pimpl->getFolderHierarchy(std::move(parentFolderIdArg), std::move(onlyChildrenArg), std::move(maxDepthArg), std::move(containerClassesArg)) };
 			}
 			else
 			{
@@ -6,6 +6,7 @@
 #include "SubscriptionObject.h"
 #include "ItemChangeObject.h"
 #include "FolderChangeObject.h"
+#include "FolderCountsObject.h"
 
 #include "graphqlservice/internal/Schema.h"
 
@@ -41,7 +42,8 @@ service::ResolverMap Subscription::getResolvers() const noexcept
 		{ R"gql(items)gql"sv, [this](service::ResolverParams&& params) { return resolveItems(std::move(params)); } },
 		{ R"gql(__typename)gql"sv, [this](service::ResolverParams&& params) { return resolve_typename(std::move(params)); } },
 		{ R"gql(subFolders)gql"sv, [this](service::ResolverParams&& params) { return resolveSubFolders(std::move(params)); } },
-		{ R"gql(rootFolders)gql"sv, [this](service::ResolverParams&& params) { return resolveRootFolders(std::move(params)); } }
+		{ R"gql(rootFolders)gql"sv, [this](service::ResolverParams&& params) { return resolveRootFolders(std::move(params)); } },
+		{ R"gql(folderCounts)gql"sv, [this](service::ResolverParams&& params) { return resolveFolderCounts(std::move(params)); } }
 	};
 }
 
@@ -88,6 +90,17 @@ service::AwaitableResolver Subscription::resolveRootFolders(service::ResolverPar
 	return service::ModifiedResult<FolderChange>::convert<service::TypeModifier::List>(std::move(result), std::move(params));
 }
 
+service::AwaitableResolver Subscription::resolveFolderCounts(service::ResolverParams&& params) const
+{
+	auto argFolderIds = service::ModifiedArgument<mapi::ObjectId>::require<service::TypeModifier::List>("folderIds", params.arguments);
+	std::unique_lock resolverLock(_resolverMutex);
+	auto directives = std::move(params.fieldDirectives);
+	auto result = _pimpl->getFolderCounts(service::FieldParams(service::SelectionSetParams{ params }, std::move(directives)), std::move(argFolderIds));
+	resolverLock.unlock();
+
+	return service::ModifiedResult<FolderCounts>::convert<service::TypeModifier::List>(std::move(result), std::move(params));
+}
+
 service::AwaitableResolver Subscription::resolve_typename(service::ResolverParams&& params) const
 {
 	return service::Result<std::string>::convert(std::string{ R"gql(Subscription)gql" }, std::move(params));
@@ -106,6 +119,9 @@ void AddSubscriptionDetails(const std::shared_ptr<schema::ObjectType>& typeSubsc
 		}),
 		schema::Field::Make(R"gql(rootFolders)gql"sv, R"md(Get updates on the root folders of a store.)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(FolderChange)gql"sv)))), {
 			schema::InputValue::Make(R"gql(storeId)gql"sv, R"md(ID of the store)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ID)gql"sv)), R"gql()gql"sv)
+		}),
+		schema::Field::Make(R"gql(folderCounts)gql"sv, R"md(Get updates on the total and unread item counts of some folders.)md"sv, std::nullopt, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(FolderCounts)gql"sv)))), {
+			schema::InputValue::Make(R"gql(folderIds)gql"sv, R"md(IDs of the folders)md"sv, schema->WrapType(introspection::TypeKind::NON_NULL, schema->WrapType(introspection::TypeKind::LIST, schema->WrapType(introspection::TypeKind::NON_NULL, schema->LookupType(R"gql(ObjectId)gql"sv)))), R"gql()gql"sv)
 		})
 	});
 }
@@ -49,6 +49,18 @@ concept getRootFolders = requires (TImpl impl, response::IdType storeIdArg)
 	{ service::AwaitableObject<std::vector<std::shared_ptr<FolderChange>>> { impl.getRootFolders(std::move(storeIdArg)) } };
 };
 
+template <class TImpl>
+concept getFolderCountsWithParams = requires (TImpl impl, service::FieldParams params, std::vector<ObjectId> folderIdsArg)
+{
+	{ service::AwaitableObject<std::vector<std::shared_ptr<FolderCounts>>> { impl.getFolderCounts(std::move(params), std::move(folderIdsArg)) } };
+};
+
+template <class TImpl>
+concept getFolderCounts = requires (TImpl impl, std::vector<ObjectId> folderIdsArg)
+{
+	{ service::AwaitableObject<std::vector<std::shared_ptr<FolderCounts>>> { impl.getFolderCounts(std::move(folderIdsArg)) } };
+};
+
 template <class TImpl>
 concept beginSelectionSet = requires (TImpl impl, const service::SelectionSetParams params)
 {
@@ -70,6 +82,7 @@ private:
 	[[nodiscard]] service::AwaitableResolver resolveItems(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveSubFolders(service::ResolverParams&& params) const;
 	[[nodiscard]] service::AwaitableResolver resolveRootFolders(service::ResolverParams&& params) const;
+	[[nodiscard]] service::AwaitableResolver resolveFolderCounts(service::ResolverParams&& params) const;
 
 	[[nodiscard]] service::AwaitableResolver resolve_typename(service::ResolverParams&& params) const;
 
@@ -83,6 +96,7 @@ private:
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<ItemChange>>> getItems(service::FieldParams&& params, ObjectId&& folderIdArg) const = 0;
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<FolderChange>>> getSubFolders(service::FieldParams&& params, ObjectId&& parentFolderIdArg) const = 0;
 		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<FolderChange>>> getRootFolders(service::FieldParams&& params, response::IdType&& storeIdArg) const = 0;
+		[[nodiscard]] virtual service::AwaitableObject<std::vector<std::shared_ptr<FolderCounts>>> getFolderCounts(service::FieldParams&& params, std::vector<ObjectId>&& folderIdsArg) const = 0;
 	};
 
 	template <class T>
@@ -142,6 +156,22 @@ private:
 			}
 		}
 
+		[[nodiscard]] service::AwaitableObject<std::vector<std::shared_ptr<FolderCounts>>> getFolderCounts(service::FieldParams&& params, std::vector<ObjectId>&& folderIdsArg) const final
+		{
+			if constexpr (methods::SubscriptionHas::getFolderCountsWithParams<T>)
+			{
+				return { _pimpl->getFolderCounts(std::move(params), std::move(folderIdsArg)) };
+			}
+			else if constexpr (methods::SubscriptionHas::getFolderCounts<T>)
+			{
+				return { _pimpl->getFolderCounts(std::move(folderIdsArg)) };
+			}
+			else
+			{
+				throw std::runtime_error(R"ex(Subscription::getFolderCounts is not implemented)ex");
+			}
+		}
+
 		void beginSelectionSet(const service::SelectionSetParams& params) const final
 		{
 			if constexpr (methods::SubscriptionHas::beginSelectionSet<T>)
@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace graphql::mapi {
+
+// Rows which were read from a MAPI table, and an index of their IDs. Nothing modifies it once it's
+// published, so readers can keep using it after it's replaced or reset.
+template <class Key, class Value>
+struct TableSnapshot
+{
+	std::vector<std::shared_ptr<Value>> rows;
+	std::map<Key, size_t> ids;
+
+	void append(std::shared_ptr<Value> row)
+	{
+		ids.emplace(row->id(), rows.size());
+		rows.push_back(std::move(row));
+	}
+
+	std::shared_ptr<Value> find(const Key& id) const
+	{
+		const auto itr = ids.find(id);
+
+		return itr == ids.cend() ? nullptr : rows[itr->second];
+	}
+};
+
+// Publishes the latest snapshots of a table, keyed by the directives they were read with. It keeps
+// up to capacity of them in LRU order, so callers which alternate between views of the same table
+// don't reload it each time. Readers only lock the table long enough to find a snapshot, only one
+// thread loads one at a time, and notification callbacks can reset all of them from any thread.
+template <class Key, class Value, class Directives>
+class SnapshotTable
+{
+public:
+	using Snapshot = TableSnapshot<Key, Value>;
+
+	explicit SnapshotTable(size_t capacity = 1) noexcept
+		: m_capacity { std::max(capacity, size_t { 1 }) }
+	{
+	}
+
+	// Return the snapshot which was read with the same directives, otherwise let the loader fill
+	// in a new one and publish that.
+	template <class Loader>
+	std::shared_ptr<const Snapshot> load(const Directives& directives, Loader&& loader)
+	{
+		if (auto cached = Find(directives))
+		{
+			return cached;
+		}
+
+		std::lock_guard loadLock { m_loadMutex };
+
+		// Another thread may have loaded it while we were waiting.
+		if (auto cached = Find(directives))
+		{
+			return cached;
+		}
+
+		size_t generation = 0;
+
+		{
+			std::lock_guard publishLock { m_publishMutex };
+
+			generation = m_generation;
+		}
+
+		auto entry = std::make_shared<Entry>();
+
+		entry->directives = directives;
+		loader(entry->snapshot);
+
+		{
+			std::lock_guard publishLock { m_publishMutex };
+
+			// If it was reset while we were reading the table, this caller still gets the rows it
+			// read, but the next one reads them again.
+			if (m_generation == generation)
+			{
+				m_entries.push_front(entry);
+
+				if (m_entries.size() > m_capacity)
+				{
+					m_entries.pop_back();
+				}
+			}
+		}
+
+		return { entry, &entry->snapshot };
+	}
+
+	// Get the most recently used snapshot whatever directives it was read with, if there is one.
+	std::shared_ptr<const Snapshot> current() const noexcept
+	{
+		std::lock_guard publishLock { m_publishMutex };
+
+		if (m_entries.empty())
+		{
+			return nullptr;
+		}
+
+		const auto& entry = m_entries.front();
+
+		return { entry, &entry->snapshot };
+	}
+
+	// Get all of the snapshots, starting with the most recently used.
+	std::vector<std::shared_ptr<const Snapshot>> snapshots() const
+	{
+		std::lock_guard publishLock { m_publishMutex };
+		std::vector<std::shared_ptr<const Snapshot>> result;
+
+		result.reserve(m_entries.size());
+		for (const auto& entry : m_entries)
+		{
+			result.emplace_back(entry, &entry->snapshot);
+		}
+
+		return result;
+	}
+
+	void reset() noexcept
+	{
+		std::lock_guard publishLock { m_publishMutex };
+
+		++m_generation;
+		m_entries.clear();
+	}
+
+private:
+	struct Entry
+	{
+		Directives directives;
+		Snapshot snapshot;
+	};
+
+	std::shared_ptr<const Snapshot> Find(const Directives& directives)
+	{
+		std::lock_guard publishLock { m_publishMutex };
+		const auto itr = std::find_if(m_entries.begin(),
+			m_entries.end(),
+			[&directives](const std::shared_ptr<const Entry>& entry) noexcept {
+				return entry->directives == directives;
+			});
+
+		if (itr == m_entries.end())
+		{
+			return nullptr;
+		}
+
+		m_entries.splice(m_entries.begin(), m_entries, itr);
+
+		const auto& entry = m_entries.front();
+
+		return { entry, &entry->snapshot };
+	}
+
+	const size_t m_capacity;
+
+	std::mutex m_loadMutex;
+	mutable std::mutex m_publishMutex;
+	size_t m_generation = 0;
+
+	// The most recently used snapshots are at the front.
+	std::list<std::shared_ptr<const Entry>> m_entries;
+};
+
+// Cache of objects by ID, split into shards which each have their own reader-writer lock, so
+// concurrent lookups only contend when they write to the same shard.
+template <class Key, class Value, class Hash, size_t ShardCount = 16>
+class ShardedCache
+{
+public:
+	std::shared_ptr<Value> find(const Key& key) const
+	{
+		const auto& shard = GetShard(key);
+		std::shared_lock lock { shard.mutex };
+		const auto itr = shard.entries.find(key);
+
+		return itr == shard.entries.cend() ? nullptr : itr->second;
+	}
+
+	// The first value which was cached for a key wins, and this returns whichever one that was.
+	std::shared_ptr<Value> insert(const Key& key, const std::shared_ptr<Value>& value)
+	{
+		auto& shard = GetShard(key);
+		std::unique_lock lock { shard.mutex };
+
+		return shard.entries.emplace(key, value).first->second;
+	}
+
+	void clear()
+	{
+		for (auto& shard : m_shards)
+		{
+			std::unique_lock lock { shard.mutex };
+
+			shard.entries.clear();
+		}
+	}
+
+private:
+	struct Shard
+	{
+		mutable std::shared_mutex mutex;
+		std::map<Key, std::shared_ptr<Value>> entries;
+	};
+
+	const Shard& GetShard(const Key& key) const
+	{
+		return m_shards[Hash {}(key) % ShardCount];
+	}
+
+	Shard& GetShard(const Key& key)
+	{
+		return m_shards[Hash {}(key) % ShardCount];
+	}
+
+	std::array<Shard, ShardCount> m_shards;
+};
+
+} // namespace graphql::mapi
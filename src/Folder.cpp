@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "Guid.h"
+#include "PropertyHelpers.h"
 #include "Types.h"
 
 #include "FolderObject.h"
@@ -37,43 +38,17 @@ Folder::Folder(const std::shared_ptr<Store>& store, IMAPIFolder* pFolder, size_t
 	, m_count { GetIntColumn(DefaultColumn::Total) }
 	, m_unread { GetIntColumn(DefaultColumn::Unread) }
 	, m_hasSubfolders { GetBoolColumn(DefaultColumn::HasSubfolders) }
-	, m_specialFolder { [this]() {
-		// Check if this folder matches a special folder, and re-use the special folder if it does.
-		auto spStore = m_store.lock();
-		const auto& specialFolders = spStore->specialFolders();
-		auto itr = std::find_if(specialFolders.begin(),
-			specialFolders.end(),
-			[this, &spStore](const auto& entry) noexcept {
-				ULONG result = 0;
-
-				return SUCCEEDED(spStore->store()->CompareEntryIDs(static_cast<ULONG>(id().size()),
-						   reinterpret_cast<LPENTRYID>(const_cast<response::IdType&>(id()).data()),
-						   static_cast<ULONG>(entry.second.size()),
-						   reinterpret_cast<LPENTRYID>(
-							   const_cast<response::IdType&>(entry.second).data()),
-						   0,
-						   &result))
-					&& result != 0;
-			});
-
-		return itr == specialFolders.end() ? std::nullopt : std::make_optional(itr->first);
-	}() }
 	, m_folder { pFolder }
+	, m_subFolders { store->tableOptions().windows }
+	, m_items { store->tableOptions().windows }
 {
 }
 
 Folder::~Folder()
 {
 	// Release all of the MAPI objects we opened and free any MAPI memory allocations.
-	if (m_subFolderSink)
-	{
-		m_subFolderSink->Unadvise();
-	}
-
-	if (m_itemSink)
-	{
-		m_itemSink.Release();
-	}
+	m_subFolderListener.reset();
+	m_itemListener.reset();
 }
 
 const response::IdType& Folder::instanceKey() const
@@ -117,10 +92,11 @@ const CComPtr<IMAPIFolder>& Folder::folder()
 	return m_folder;
 }
 
-const std::vector<std::shared_ptr<Folder>>& Folder::subFolders()
+std::shared_ptr<const std::vector<std::shared_ptr<Folder>>> Folder::subFolders()
 {
-	LoadSubFolders({});
-	return *m_subFolders;
+	auto subFolders = LoadSubFolders({});
+
+	return { subFolders, &subFolders->rows };
 }
 
 std::shared_ptr<Folder> Folder::parentFolder() const
@@ -130,36 +106,19 @@ std::shared_ptr<Folder> Folder::parentFolder() const
 
 std::shared_ptr<Folder> Folder::lookupSubFolder(const response::IdType& id)
 {
-	LoadSubFolders({});
-
-	auto itr = m_subFolderIds->find(id);
-
-	if (itr == m_subFolderIds->cend())
-	{
-		return nullptr;
-	}
-
-	return m_subFolders->at(itr->second);
+	return LoadSubFolders({})->find(id);
 }
 
-const std::vector<std::shared_ptr<Item>>& Folder::items()
+std::shared_ptr<const std::vector<std::shared_ptr<Item>>> Folder::items()
 {
-	LoadItems({});
-	return *m_items;
+	auto items = LoadItems({});
+
+	return { items, &items->rows };
 }
 
 std::shared_ptr<Item> Folder::lookupItem(const response::IdType& id)
 {
-	LoadItems({});
-
-	auto itr = m_itemIds->find(id);
-
-	if (itr == m_itemIds->cend())
-	{
-		return nullptr;
-	}
-
-	return m_items->at(itr->second);
+	return LoadItems({})->find(id);
 }
 
 const SPropValue& Folder::GetColumnProp(DefaultColumn column) const
@@ -224,6 +183,8 @@ bool Folder::GetBoolColumn(DefaultColumn column) const
 
 void Folder::OpenFolder()
 {
+	std::lock_guard lock { m_openMutex };
+
 	if (m_folder)
 	{
 		return;
@@ -241,23 +202,108 @@ void Folder::OpenFolder()
 	CFRt(objType == MAPI_FOLDER);
 }
 
-void Folder::LoadSubFolders(service::Directives&& fieldDirectives)
+void Folder::LoadSpecialFolder()
 {
-	if (m_subFolderDirectives != fieldDirectives)
+	std::lock_guard lock { m_openMutex };
+
+	if (m_specialFolder)
 	{
-		// Reset the subFolders and reload if the directives change
-		m_subFolders.reset();
-		m_subFolderDirectives = std::move(fieldDirectives);
+		return;
 	}
 
-	if (m_subFolders)
+	// Check if this folder matches a special folder, and re-use the special folder if it does.
+	auto spStore = m_store.lock();
+	const auto& specialFolders = spStore->specialFolders();
+	auto itr = std::find_if(specialFolders.begin(),
+		specialFolders.end(),
+		[this, &spStore](const auto& entry) noexcept {
+			ULONG result = 0;
+
+			return SUCCEEDED(spStore->store()->CompareEntryIDs(static_cast<ULONG>(m_id.size()),
+					   reinterpret_cast<LPENTRYID>(const_cast<response::IdType&>(m_id).data()),
+					   static_cast<ULONG>(entry.second.size()),
+					   reinterpret_cast<LPENTRYID>(
+						   const_cast<response::IdType&>(entry.second).data()),
+					   0,
+					   &result))
+				&& result != 0;
+		});
+
+	m_specialFolder = std::make_unique<std::optional<SpecialFolder>>(
+		itr == specialFolders.end() ? std::nullopt : std::make_optional(itr->first));
+}
+
+std::vector<std::shared_ptr<Folder>> Folder::LookupSubFolders(
+	const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids)
+{
+	if (ids.empty())
 	{
-		return;
+		return {};
+	}
+
+	auto store = m_store.lock();
+	const TableDirectives directives { store, fieldDirectives };
+	CComPtr<IMAPITable> sptable;
+
+	CORt(folder()->GetHierarchyTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
+
+	const rowset_ptr sprows = directives.lookup(sptable, store->GetFolderProperties(), ids);
+
+	if (!sprows)
+	{
+		// The provider can't restrict the table, so look for them in the current window.
+		const auto subFolders = LoadSubFolders(fieldDirectives);
+		std::vector<std::shared_ptr<Folder>> result;
+
+		result.reserve(ids.size());
+		for (const auto& id : ids)
+		{
+			auto folder = subFolders->find(id);
+
+			if (folder)
+			{
+				result.push_back(std::move(folder));
+			}
+		}
+
+		return result;
 	}
 
-	m_subFolderIds = std::make_unique<std::map<response::IdType, size_t>>();
-	m_subFolders = std::make_unique<std::vector<std::shared_ptr<Folder>>>();
+	std::vector<std::shared_ptr<Folder>> subFolders;
+
+	subFolders.reserve(static_cast<size_t>(sprows->cRows));
+	for (ULONG i = 0; i != sprows->cRows; i++)
+	{
+		auto& row = sprows->aRow[i];
+		const size_t columnCount = static_cast<size_t>(row.cValues);
+		mapi_ptr<SPropValue> columns { row.lpProps };
+
+		row.lpProps = nullptr;
 
+		auto folder = std::make_shared<Folder>(store, nullptr, columnCount, std::move(columns));
+
+		// Return the columns this request read, even if another request cached the folder first.
+		store->CacheFolder(folder);
+		subFolders.push_back(std::move(folder));
+	}
+
+	return store->MatchEntryIds(ids, subFolders);
+}
+
+std::shared_ptr<const FolderSnapshot> Folder::LoadSubFolders(
+	const service::Directives& fieldDirectives)
+{
+	// Keep a window for each set of table directives.
+	const TableDirectives directives { m_store.lock(), fieldDirectives };
+
+	return m_subFolders.load(directives.canonicalKey(),
+		[this, &directives](FolderSnapshot& snapshot) {
+			ReadSubFolders(directives, snapshot);
+		});
+}
+
+void Folder::ReadSubFolders(const TableDirectives& directives, FolderSnapshot& snapshot)
+{
 	constexpr auto c_folderProps = GetFolderColumns();
 	mapi_ptr<SPropTagArray> folderProps;
 
@@ -279,7 +325,6 @@ void Folder::LoadSubFolders(service::Directives&& fieldDirectives)
 	std::copy(c_folderSorts.begin(), c_folderSorts.end(), folderSorts->aSort);
 
 	auto store = m_store.lock();
-	const TableDirectives directives { store, m_subFolderDirectives };
 	CComPtr<IMAPITable> sptable;
 
 	CORt(folder()->GetHierarchyTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
@@ -287,7 +332,7 @@ void Folder::LoadSubFolders(service::Directives&& fieldDirectives)
 	const rowset_ptr sprows =
 		directives.read(sptable, std::move(folderProps), std::move(folderSorts));
 
-	m_subFolders->reserve(static_cast<size_t>(sprows->cRows));
+	snapshot.rows.reserve(static_cast<size_t>(sprows->cRows));
 	for (ULONG i = 0; i != sprows->cRows; i++)
 	{
 		auto& row = sprows->aRow[i];
@@ -299,50 +344,93 @@ void Folder::LoadSubFolders(service::Directives&& fieldDirectives)
 		auto folder = std::make_shared<Folder>(store, nullptr, columnCount, std::move(columns));
 
 		store->CacheFolder(folder);
-		m_subFolderIds->insert(std::make_pair(folder->id(), m_subFolders->size()));
-		m_subFolders->push_back(std::move(folder));
+		snapshot.append(std::move(folder));
 	}
 
-	if (!m_subFolderSink)
+	if (!m_subFolderListener)
 	{
-		auto spThis = shared_from_this();
-		CComPtr<AdviseSinkProxy<IMAPITable>> sinkProxy;
-		ULONG_PTR connectionId = 0;
-
-		sinkProxy.Attach(new AdviseSinkProxy<IMAPITable>(
-			[wpFolder = std::weak_ptr { spThis }](size_t, LPNOTIFICATION) {
+		m_subFolderListener = store->notifications()->subscribe(m_id,
+			MAPI_FOLDER,
+			[wpFolder = weak_from_this()](const NOTIFICATION&) {
 				auto spFolder = wpFolder.lock();
 
 				if (spFolder)
 				{
 					spFolder->m_subFolders.reset();
 				}
-			}));
-
-		CORt(sptable->Advise(fnevTableModified, sinkProxy, &connectionId));
-		sinkProxy->OnAdvise(sptable, connectionId);
-
-		m_subFolderSink = sinkProxy;
+			});
 	}
 }
 
-void Folder::LoadItems(service::Directives&& fieldDirectives)
+std::vector<std::shared_ptr<Item>> Folder::LookupItems(
+	const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids)
 {
-	if (m_itemDirectives != fieldDirectives)
+	if (ids.empty())
 	{
-		// Reset the items and reload if the directives change
-		m_items.reset();
-		m_itemDirectives = std::move(fieldDirectives);
+		return {};
 	}
 
-	if (m_items)
+	auto store = m_store.lock();
+	const TableDirectives directives { store, fieldDirectives };
+	CComPtr<IMAPITable> sptable;
+
+	CORt(folder()->GetContentsTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
+
+	const rowset_ptr sprows = directives.lookup(sptable, store->GetItemProperties(), ids);
+
+	if (!sprows)
 	{
-		return;
+		// The provider can't restrict the table, so look for them in the current window.
+		const auto items = LoadItems(fieldDirectives);
+		std::vector<std::shared_ptr<Item>> result;
+
+		result.reserve(ids.size());
+		for (const auto& id : ids)
+		{
+			auto item = items->find(id);
+
+			if (item)
+			{
+				result.push_back(std::move(item));
+			}
+		}
+
+		return result;
 	}
 
-	m_itemIds = std::make_unique<std::map<response::IdType, size_t>>();
-	m_items = std::make_unique<std::vector<std::shared_ptr<Item>>>();
+	std::vector<std::shared_ptr<Item>> items;
+
+	items.reserve(static_cast<size_t>(sprows->cRows));
+	for (ULONG i = 0; i != sprows->cRows; i++)
+	{
+		auto& row = sprows->aRow[i];
+		const size_t columnCount = static_cast<size_t>(row.cValues);
+		mapi_ptr<SPropValue> columns { row.lpProps };
+
+		row.lpProps = nullptr;
 
+		auto item = std::make_shared<Item>(store, nullptr, columnCount, std::move(columns));
+
+		// Return the columns this request read, even if another request cached the item first.
+		store->CacheItem(item);
+		items.push_back(std::move(item));
+	}
+
+	return store->MatchEntryIds(ids, items);
+}
+
+std::shared_ptr<const ItemSnapshot> Folder::LoadItems(const service::Directives& fieldDirectives)
+{
+	// Keep a window for each set of table directives.
+	const TableDirectives directives { m_store.lock(), fieldDirectives };
+
+	return m_items.load(directives.canonicalKey(), [this, &directives](ItemSnapshot& snapshot) {
+		ReadItems(directives, snapshot);
+	});
+}
+
+void Folder::ReadItems(const TableDirectives& directives, ItemSnapshot& snapshot)
+{
 	constexpr auto c_itemProps = Item::GetItemColumns();
 	mapi_ptr<SPropTagArray> itemProps;
 
@@ -364,14 +452,13 @@ void Folder::LoadItems(service::Directives&& fieldDirectives)
 	std::copy(c_itemSorts.begin(), c_itemSorts.end(), itemSorts->aSort);
 
 	auto store = m_store.lock();
-	const TableDirectives directives { store, m_itemDirectives };
 	CComPtr<IMAPITable> sptable;
 
 	CORt(folder()->GetContentsTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
 
 	const rowset_ptr sprows = directives.read(sptable, std::move(itemProps), std::move(itemSorts));
 
-	m_items->reserve(static_cast<size_t>(sprows->cRows));
+	snapshot.rows.reserve(static_cast<size_t>(sprows->cRows));
 	for (ULONG i = 0; i != sprows->cRows; i++)
 	{
 		auto& row = sprows->aRow[i];
@@ -383,30 +470,21 @@ void Folder::LoadItems(service::Directives&& fieldDirectives)
 		auto item = std::make_shared<Item>(store, nullptr, columnCount, std::move(columns));
 
 		store->CacheItem(item);
-		m_itemIds->insert({ item->id(), m_items->size() });
-		m_items->push_back(std::move(item));
+		snapshot.append(std::move(item));
 	}
 
-	if (!m_itemSink)
+	if (!m_itemListener)
 	{
-		auto spThis = shared_from_this();
-		CComPtr<AdviseSinkProxy<IMAPITable>> sinkProxy;
-		ULONG_PTR connectionId = 0;
-
-		sinkProxy.Attach(new AdviseSinkProxy<IMAPITable>(
-			[wpFolder = std::weak_ptr { spThis }](size_t, LPNOTIFICATION) {
+		m_itemListener = store->notifications()->subscribe(m_id,
+			MAPI_MESSAGE,
+			[wpFolder = weak_from_this()](const NOTIFICATION&) {
 				auto spFolder = wpFolder.lock();
 
 				if (spFolder)
 				{
 					spFolder->m_items.reset();
 				}
-			}));
-
-		CORt(sptable->Advise(fnevTableModified, sinkProxy, &connectionId));
-		sinkProxy->OnAdvise(sptable, connectionId);
-
-		m_itemSink = sinkProxy;
+			});
 	}
 }
 
@@ -415,9 +493,19 @@ const response::IdType& Folder::getId() const
 	return m_id;
 }
 
-std::shared_ptr<object::Folder> Folder::getParentFolder() const
+service::AwaitableObject<std::shared_ptr<object::Folder>> Folder::getParentFolder() const
 {
-	return std::make_shared<object::Folder>(parentFolder());
+	const auto spThis = shared_from_this();
+	const auto store = m_store.lock();
+
+	if (m_parentId != m_id)
+	{
+		store->QueueFolder(m_parentId);
+	}
+
+	co_await store->executor()->schedule(store.get());
+	store->OpenQueuedFolders();
+	co_return std::make_shared<object::Folder>(parentFolder());
 }
 
 std::shared_ptr<object::Store> Folder::getStore() const
@@ -445,9 +533,14 @@ std::optional<std::string> Folder::getContainerClass() const
     return m_containerClass.empty() ? std::nullopt : std::make_optional(m_containerClass);
 }
 
-std::optional<SpecialFolder> Folder::getSpecialFolder() const
+service::AwaitableScalar<std::optional<SpecialFolder>> Folder::getSpecialFolder()
 {
-	return m_specialFolder;
+	const auto spThis = shared_from_this();
+	const auto store = m_store.lock();
+
+	co_await store->executor()->schedule(store.get());
+	LoadSpecialFolder();
+	co_return *m_specialFolder;
 }
 
 std::vector<std::shared_ptr<object::Property>> Folder::getColumns() const
@@ -459,37 +552,62 @@ std::vector<std::shared_ptr<object::Property>> Folder::getColumns() const
 	return { store->GetColumns(m_columnCount - offset, m_columns.get() + offset) };
 }
 
-std::vector<std::shared_ptr<object::Folder>> Folder::getSubFolders(
-	service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg)
+std::vector<std::shared_ptr<object::Property>> Folder::changedColumns(const Folder& previous) const
 {
-	std::vector<std::shared_ptr<object::Folder>> result {};
+	auto changed = prop::GetChangedColumns(previous.m_columnCount,
+		previous.m_columns.get(),
+		m_columnCount,
+		m_columns.get());
+
+	if (changed.empty())
+	{
+		return {};
+	}
+
+	auto store = m_store.lock();
+
+	return { store->GetColumns(changed.size(), changed.data()) };
+}
+
+service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> Folder::getSubFolders(
+	service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg)
+{
+	const auto spThis = shared_from_this();
+	const auto store = m_store.lock();
+	const auto fieldDirectives = std::move(params.fieldDirectives);
+
+	co_await store->executor()->schedule(store.get());
 
-	LoadSubFolders(std::move(params.fieldDirectives));
+	std::vector<std::shared_ptr<object::Folder>> result {};
 
 	if (idsArg)
 	{
+		const auto subFolders = LookupSubFolders(fieldDirectives, *idsArg);
+
 		// Lookup the folders with the specified IDs
-		result.resize(idsArg->size());
-		std::transform(idsArg->cbegin(),
-			idsArg->cend(),
+		result.resize(subFolders.size());
+		std::transform(subFolders.cbegin(),
+			subFolders.cend(),
 			result.begin(),
-			[this](const response::IdType& id) noexcept {
-				return std::make_shared<object::Folder>(lookupSubFolder(id));
+			[](const std::shared_ptr<Folder>& folder) noexcept {
+				return std::make_shared<object::Folder>(folder);
 			});
 	}
 	else
 	{
+		const auto subFolders = LoadSubFolders(fieldDirectives);
+
 		// Just clone the entire vector of folders.
-		result.resize(m_subFolders->size());
-		std::transform(m_subFolders->cbegin(),
-			m_subFolders->cend(),
+		result.resize(subFolders->rows.size());
+		std::transform(subFolders->rows.cbegin(),
+			subFolders->rows.cend(),
 			result.begin(),
 			[this](const std::shared_ptr<Folder>& folder) noexcept {
 				return std::make_shared<object::Folder>(folder);
 			});
 	}
 
-	return result;
+	co_return result;
 }
 
 std::vector<std::shared_ptr<object::Conversation>> Folder::getConversations(
@@ -499,37 +617,45 @@ std::vector<std::shared_ptr<object::Conversation>> Folder::getConversations(
 	return {};
 }
 
-std::vector<std::shared_ptr<object::Item>> Folder::getItems(
-	service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Item>>> Folder::getItems(
+	service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg)
 {
-	std::vector<std::shared_ptr<object::Item>> result {};
+	const auto spThis = shared_from_this();
+	const auto store = m_store.lock();
+	const auto fieldDirectives = std::move(params.fieldDirectives);
 
-	LoadItems(std::move(params.fieldDirectives));
+	co_await store->executor()->schedule(store.get());
+
+	std::vector<std::shared_ptr<object::Item>> result {};
 
 	if (idsArg)
 	{
+		const auto items = LookupItems(fieldDirectives, *idsArg);
+
 		// Lookup the items with the specified IDs
-		result.resize(idsArg->size());
-		std::transform(idsArg->cbegin(),
-			idsArg->cend(),
+		result.resize(items.size());
+		std::transform(items.cbegin(),
+			items.cend(),
 			result.begin(),
-			[this](const response::IdType& id) noexcept {
-				return std::make_shared<object::Item>(lookupItem(id));
+			[](const std::shared_ptr<Item>& item) noexcept {
+				return std::make_shared<object::Item>(item);
 			});
 	}
 	else
 	{
+		const auto items = LoadItems(fieldDirectives);
+
 		// Just clone the entire vector of items.
-		result.resize(m_items->size());
-		std::transform(m_items->cbegin(),
-			m_items->cend(),
+		result.resize(items->rows.size());
+		std::transform(items->rows.cbegin(),
+			items->rows.cend(),
 			result.begin(),
 			[this](const std::shared_ptr<Item>& item) noexcept {
 				return std::make_shared<object::Item>(item);
 			});
 	}
 
-	return result;
+	co_return result;
 }
 
 } // namespace graphql::mapi
\ No newline at end of file
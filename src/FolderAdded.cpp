@@ -8,12 +8,18 @@
 
 namespace graphql::mapi {
 
-FolderAdded::FolderAdded(int index, const std::shared_ptr<Folder>& added)
-	: m_index { index }
+FolderAdded::FolderAdded(int sequence, int index, const std::shared_ptr<Folder>& added)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_added { added }
 {
 }
 
+int FolderAdded::getSequence() const
+{
+	return m_sequence;
+}
+
 int FolderAdded::getIndex() const
 {
 	return m_index;
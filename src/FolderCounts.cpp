@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+FolderCounts::FolderCounts(const ObjectId& folderId, int count, int unread)
+	: m_folderId { folderId }
+	, m_count { count }
+	, m_unread { unread }
+{
+}
+
+const response::IdType& FolderCounts::getStoreId() const
+{
+	return m_folderId.storeId;
+}
+
+const response::IdType& FolderCounts::getFolderId() const
+{
+	return m_folderId.objectId;
+}
+
+int FolderCounts::getCount() const
+{
+	return m_count;
+}
+
+int FolderCounts::getUnread() const
+{
+	return m_unread;
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
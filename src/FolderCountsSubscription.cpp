@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+FolderCountsSubscription::FolderCountsSubscription(
+	std::vector<std::shared_ptr<object::FolderCounts>>&& folderCounts)
+	: m_folderCounts { std::move(folderCounts) }
+{
+}
+
+std::vector<std::shared_ptr<object::ItemChange>> FolderCountsSubscription::getItems(
+	ObjectId&& folderIdArg) const
+{
+	return {};
+}
+
+std::vector<std::shared_ptr<object::FolderChange>> FolderCountsSubscription::getSubFolders(
+	ObjectId&& parentFolderIdArg) const
+{
+	return {};
+}
+
+std::vector<std::shared_ptr<object::FolderChange>> FolderCountsSubscription::getRootFolders(
+	response::IdType&& storeIdArg) const
+{
+	return {};
+}
+
+std::vector<std::shared_ptr<object::FolderCounts>> FolderCountsSubscription::getFolderCounts(
+	std::vector<ObjectId>&& folderIdsArg) const
+{
+	return m_folderCounts;
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
@@ -6,12 +6,18 @@
 
 namespace graphql::mapi {
 
-FolderRemoved::FolderRemoved(int index, const response::IdType& removed)
-	: m_index { index }
+FolderRemoved::FolderRemoved(int sequence, int index, const response::IdType& removed)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_removed { removed }
 {
 }
 
+int FolderRemoved::getSequence() const
+{
+	return m_sequence;
+}
+
 int FolderRemoved::getIndex() const
 {
 	return m_index;
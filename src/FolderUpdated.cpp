@@ -8,12 +8,20 @@
 
 namespace graphql::mapi {
 
-FolderUpdated::FolderUpdated(int index, const std::shared_ptr<Folder>& updated)
-	: m_index { index }
+FolderUpdated::FolderUpdated(int sequence, int index, const std::shared_ptr<Folder>& updated,
+	const std::shared_ptr<Folder>& previous)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_updated { updated }
+	, m_previous { previous }
 {
 }
 
+int FolderUpdated::getSequence() const
+{
+	return m_sequence;
+}
+
 int FolderUpdated::getIndex() const
 {
 	return m_index;
@@ -24,4 +32,14 @@ std::shared_ptr<object::Folder> FolderUpdated::getUpdated() const
 	return std::make_shared<object::Folder>(m_updated);
 }
 
+std::optional<std::vector<std::shared_ptr<object::Property>>> FolderUpdated::getChangedFields() const
+{
+	if (!m_previous)
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(m_updated->changedColumns(*m_previous));
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
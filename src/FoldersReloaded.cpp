@@ -8,11 +8,17 @@
 
 namespace graphql::mapi {
 
-FoldersReloaded::FoldersReloaded(const std::vector<std::shared_ptr<Folder>>& reloaded)
-	: m_reloaded { reloaded }
+FoldersReloaded::FoldersReloaded(int sequence, const std::vector<std::shared_ptr<Folder>>& reloaded)
+	: m_sequence { sequence }
+	, m_reloaded { reloaded }
 {
 }
 
+int FoldersReloaded::getSequence() const
+{
+	return m_sequence;
+}
+
 std::vector<std::shared_ptr<object::Folder>> FoldersReloaded::getReloaded() const
 {
 	std::vector<std::shared_ptr<object::Folder>> result(m_reloaded.size());
@@ -54,4 +54,35 @@ mapi::MultipleItemsInput from_input(mapi::MultipleItemsInput&& input)
 	return input;
 }
 
-} // namespace convert::input
+bool matches_input(const response::Value& value, const response::IdType& input)
+{
+	// IdType compares the base64 encoding of a string argument to the bytes without decoding it.
+	switch (value.type())
+	{
+		case response::Type::ID:
+			return value.get<response::IdType>() == input;
+
+		case response::Type::String:
+			return input == value.get<response::StringType>();
+
+		default:
+			return false;
+	}
+}
+
+bool matches_input(const response::Value& value, const mapi::ObjectId& input)
+{
+	if (value.type() != response::Type::Map)
+	{
+		return false;
+	}
+
+	const auto itrStoreId = value.find("storeId");
+	const auto itrObjectId = value.find("objectId");
+
+	return itrStoreId != value.end() && itrObjectId != value.end()
+		&& matches_input(itrObjectId->second, input.objectId)
+		&& matches_input(itrStoreId->second, input.storeId);
+}
+
+} // namespace convert::input
\ No newline at end of file
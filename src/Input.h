@@ -13,4 +13,9 @@ graphql::mapi::PropValueInput from_input(graphql::mapi::PropValueInput&& input);
 graphql::mapi::CreateItemInput from_input(graphql::mapi::CreateItemInput&& input);
 graphql::mapi::MultipleItemsInput from_input(graphql::mapi::MultipleItemsInput&& input);
 
+// Compare an argument value from a subscriber to the converted one a subscription was registered
+// with, without converting the argument again.
+bool matches_input(const graphql::response::Value& value, const graphql::response::IdType& input);
+bool matches_input(const graphql::response::Value& value, const graphql::mapi::ObjectId& input);
+
 } // namespace convert::input
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "DateTime.h"
+#include "PropertyHelpers.h"
 #include "Types.h"
 
 #include "AttachmentObject.h"
@@ -154,6 +155,8 @@ FILETIME Item::GetTimeColumn(DefaultColumn column) const
 
 void Item::OpenItem()
 {
+	std::lock_guard lock { m_openMutex };
+
 	if (m_message)
 	{
 		return;
@@ -176,9 +179,15 @@ const response::IdType& Item::getId() const
 	return m_id;
 }
 
-std::shared_ptr<object::Folder> Item::getParentFolder() const
+service::AwaitableObject<std::shared_ptr<object::Folder>> Item::getParentFolder() const
 {
-	return std::make_shared<object::Folder>(m_store.lock()->OpenFolder(m_parentId));
+	const auto spThis = shared_from_this();
+	const auto store = m_store.lock();
+
+	store->QueueFolder(m_parentId);
+	co_await store->executor()->schedule(store.get());
+	store->OpenQueuedFolders();
+	co_return std::make_shared<object::Folder>(store->OpenFolder(m_parentId));
 }
 
 std::shared_ptr<object::Conversation> Item::getConversation(service::FieldParams&& params) const
@@ -242,6 +251,23 @@ std::vector<std::shared_ptr<object::Property>> Item::getColumns() const
 	return { store->GetColumns(m_columnCount - offset, m_columns.get() + offset) };
 }
 
+std::vector<std::shared_ptr<object::Property>> Item::changedColumns(const Item& previous) const
+{
+	auto changed = prop::GetChangedColumns(previous.m_columnCount,
+		previous.m_columns.get(),
+		m_columnCount,
+		m_columns.get());
+
+	if (changed.empty())
+	{
+		return {};
+	}
+
+	auto store = m_store.lock();
+
+	return { store->GetColumns(changed.size(), changed.data()) };
+}
+
 std::vector<std::shared_ptr<object::Attachment>> Item::getAttachments(
 	service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg) const
 {
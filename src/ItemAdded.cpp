@@ -8,12 +8,18 @@
 
 namespace graphql::mapi {
 
-ItemAdded::ItemAdded(int index, const std::shared_ptr<Item>& added)
-	: m_index { index }
+ItemAdded::ItemAdded(int sequence, int index, const std::shared_ptr<Item>& added)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_added { added }
 {
 }
 
+int ItemAdded::getSequence() const
+{
+	return m_sequence;
+}
+
 int ItemAdded::getIndex() const
 {
 	return m_index;
@@ -6,12 +6,18 @@
 
 namespace graphql::mapi {
 
-ItemRemoved::ItemRemoved(int index, const response::IdType& removed)
-	: m_index { index }
+ItemRemoved::ItemRemoved(int sequence, int index, const response::IdType& removed)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_removed { removed }
 {
 }
 
+int ItemRemoved::getSequence() const
+{
+	return m_sequence;
+}
+
 int ItemRemoved::getIndex() const
 {
 	return m_index;
@@ -8,12 +8,20 @@
 
 namespace graphql::mapi {
 
-ItemUpdated::ItemUpdated(int index, const std::shared_ptr<Item>& updated)
-	: m_index { index }
+ItemUpdated::ItemUpdated(int sequence, int index, const std::shared_ptr<Item>& updated,
+	const std::shared_ptr<Item>& previous)
+	: m_sequence { sequence }
+	, m_index { index }
 	, m_updated { updated }
+	, m_previous { previous }
 {
 }
 
+int ItemUpdated::getSequence() const
+{
+	return m_sequence;
+}
+
 int ItemUpdated::getIndex() const
 {
 	return m_index;
@@ -24,4 +32,14 @@ std::shared_ptr<object::Item> ItemUpdated::getUpdated() const
 	return std::make_shared<object::Item>(m_updated);
 }
 
+std::optional<std::vector<std::shared_ptr<object::Property>>> ItemUpdated::getChangedFields() const
+{
+	if (!m_previous)
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(m_updated->changedColumns(*m_previous));
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
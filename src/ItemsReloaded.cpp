@@ -8,11 +8,17 @@
 
 namespace graphql::mapi {
 
-ItemsReloaded::ItemsReloaded(const std::vector<std::shared_ptr<Item>>& reloaded)
-	: m_reloaded { reloaded }
+ItemsReloaded::ItemsReloaded(int sequence, const std::vector<std::shared_ptr<Item>>& reloaded)
+	: m_sequence { sequence }
+	, m_reloaded { reloaded }
 {
 }
 
+int ItemsReloaded::getSequence() const
+{
+	return m_sequence;
+}
+
 std::vector<std::shared_ptr<object::Item>> ItemsReloaded::getReloaded() const
 {
 	std::vector<std::shared_ptr<object::Item>> result(m_reloaded.size());
@@ -6,13 +6,21 @@
 
 namespace graphql::mapi {
 
-ItemsSubscription::ItemsSubscription(std::vector<std::shared_ptr<object::ItemChange>>&& items)
+ItemsSubscription::ItemsSubscription(std::vector<std::shared_ptr<object::ItemChange>>&& items,
+	std::optional<int> resumedFrom)
 	: m_items { std::move(items) }
+	, m_resumedFrom { resumedFrom }
 {
 }
 
-std::vector<std::shared_ptr<object::ItemChange>> ItemsSubscription::getItems(ObjectId&& folderIdArg) const
+std::vector<std::shared_ptr<object::ItemChange>> ItemsSubscription::getItems(
+	service::FieldParams&& params, ObjectId&& folderIdArg) const
 {
+	if (m_resumedFrom && Subscription::GetResumeDirective(params.fieldDirectives) != m_resumedFrom)
+	{
+		return {};
+	}
+
 	return m_items;
 }
 
@@ -28,4 +36,10 @@ std::vector<std::shared_ptr<object::FolderChange>> ItemsSubscription::getRootFol
 	return {};
 }
 
+std::vector<std::shared_ptr<object::FolderCounts>> ItemsSubscription::getFolderCounts(
+	std::vector<ObjectId>&& folderIdsArg) const
+{
+	return {};
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
@@ -81,6 +81,7 @@ bool Mutation::CopyItems(MultipleItemsInput&& inputArg, ObjectId&& destinationAr
 
 void Mutation::endSelectionSet(const service::SelectionSetParams&)
 {
+	m_query->invalidateResponses();
 	m_query->ClearCaches();
 }
 
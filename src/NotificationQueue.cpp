@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+NotificationQueue::NotificationQueue(const SubscriptionOptions& options)
+	: m_state { std::make_shared<State>() }
+{
+	m_state->capacity = std::max<size_t>(options.dispatchQueueCapacity, 1);
+	m_state->policy = options.queueFullPolicy;
+	m_state->metrics = options.queueMetrics ? options.queueMetrics
+											: std::make_shared<NotificationQueueMetrics>();
+
+	m_threads.reserve(options.dispatchThreads);
+	for (size_t i = 0; i < options.dispatchThreads; ++i)
+	{
+		m_threads.emplace_back([state = m_state]() {
+			// The callbacks read the tables and resolve the payloads, so they need MAPI too.
+			const MAPIThreadScope scope;
+
+			Run(state);
+		});
+	}
+}
+
+NotificationQueue::~NotificationQueue()
+{
+	std::deque<Work> pending;
+
+	{
+		std::lock_guard lock { m_state->mutex };
+
+		m_state->stopped = true;
+		pending = std::move(m_state->queue);
+		m_state->queue.clear();
+		m_state->batches = 0;
+		UpdateDepth(*m_state);
+	}
+
+	m_state->workAvailable.notify_all();
+	m_state->roomAvailable.notify_all();
+
+	for (auto& thread : m_threads)
+	{
+		if (thread.get_id() == std::this_thread::get_id())
+		{
+			// One of our own callbacks released the last reference, the thread will exit as soon
+			// as it returns.
+			thread.detach();
+		}
+		else
+		{
+			thread.join();
+		}
+	}
+}
+
+void NotificationQueue::push(Key key, Callback&& callback, Callback&& reload)
+{
+	auto& state = *m_state;
+	std::unique_lock lock { state.mutex };
+
+	if (state.reloads.find(key) != state.reloads.end())
+	{
+		// The reload which is already queued will pick up these changes.
+		++state.metrics->dropped;
+		return;
+	}
+
+	if (state.batches >= state.capacity)
+	{
+		switch (state.policy)
+		{
+			case QueueFullPolicy::Block:
+				++state.metrics->blocked;
+				state.roomAvailable.wait(lock, [&state]() noexcept {
+					return state.stopped || state.batches < state.capacity;
+				});
+
+				if (state.stopped)
+				{
+					return;
+				}
+
+				break;
+
+			case QueueFullPolicy::DropToReload:
+				++state.metrics->dropped;
+				++state.metrics->reloads;
+				state.reloads.insert(key);
+				state.queue.push_back({ key, std::move(reload), false, true });
+				UpdateDepth(state);
+				lock.unlock();
+				state.workAvailable.notify_all();
+				return;
+		}
+	}
+
+	++state.batches;
+	++state.metrics->queued;
+	state.queue.push_back({ key, std::move(callback), true, false });
+	UpdateDepth(state);
+	lock.unlock();
+	state.workAvailable.notify_all();
+}
+
+void NotificationQueue::post(Key key, Callback&& callback)
+{
+	auto& state = *m_state;
+
+	{
+		std::lock_guard lock { state.mutex };
+
+		if (state.stopped)
+		{
+			return;
+		}
+
+		state.queue.push_back({ key, std::move(callback), false, false });
+		UpdateDepth(state);
+	}
+
+	state.workAvailable.notify_all();
+}
+
+void NotificationQueue::Run(const std::shared_ptr<State>& state)
+{
+	std::unique_lock lock { state->mutex };
+
+	while (!state->stopped)
+	{
+		// Take the oldest work for a key which isn't already running on another thread.
+		const auto itr = std::find_if(state->queue.begin(),
+			state->queue.end(),
+			[&busy = state->busy](const Work& work) noexcept {
+				return busy.find(work.key) == busy.end();
+			});
+
+		if (itr == state->queue.end())
+		{
+			state->workAvailable.wait(lock);
+			continue;
+		}
+
+		const auto key = itr->key;
+		const bool batch = itr->batch;
+
+		{
+			// Release the callback before re-acquiring the lock, it might hold the last reference
+			// to the NotificationQueue.
+			auto callback = std::move(itr->callback);
+
+			if (itr->reload)
+			{
+				// Anything which arrives after this point needs to be queued again.
+				state->reloads.erase(key);
+			}
+
+			state->queue.erase(itr);
+
+			if (batch)
+			{
+				--state->batches;
+			}
+
+			state->busy.insert(key);
+			UpdateDepth(*state);
+			lock.unlock();
+
+			if (batch)
+			{
+				state->roomAvailable.notify_one();
+			}
+
+			try
+			{
+				callback();
+			}
+			catch (const std::exception&)
+			{
+				// CORt and CFRt already reported the error, keep running the other callbacks.
+			}
+
+			if (batch)
+			{
+				++state->metrics->processed;
+			}
+		}
+
+		lock.lock();
+		state->busy.erase(key);
+
+		// There may be more work waiting for the same key.
+		state->workAvailable.notify_all();
+	}
+}
+
+void NotificationQueue::UpdateDepth(State& state) noexcept
+{
+	const size_t depth = state.queue.size();
+
+	state.metrics->depth = depth;
+
+	if (depth > state.metrics->maxDepth)
+	{
+		state.metrics->maxDepth = depth;
+	}
+}
+
+} // namespace graphql::mapi
@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+namespace {
+
+// Forget the aliases and unmatched IDs once there are this many, so they don't grow without bound.
+constexpr size_t c_maxRememberedIds = 1024;
+
+// Copy the entry ID in the form the listeners are keyed by. Providers mark short-term entry IDs in
+// the ENTRYID::abFlags, which is the most common difference between the IDs in the tables and in
+// the notifications, so clear them and compare the rest of the bytes.
+response::IdType NormalizeEntryId(ULONG cbEntryId, LPENTRYID pEntryId)
+{
+	if (cbEntryId == 0 || pEntryId == nullptr)
+	{
+		return {};
+	}
+
+	const auto idBegin = reinterpret_cast<const std::uint8_t*>(pEntryId);
+	const auto idEnd = idBegin + static_cast<size_t>(cbEntryId);
+	response::IdType result { idBegin, idEnd };
+
+	if (result.size() > sizeof(pEntryId->abFlags))
+	{
+		std::fill_n(result.begin(), sizeof(pEntryId->abFlags), std::uint8_t { 0 });
+	}
+
+	return result;
+}
+
+response::IdType NormalizeEntryId(const response::IdType& id)
+{
+	return NormalizeEntryId(static_cast<ULONG>(id.size()),
+		reinterpret_cast<LPENTRYID>(const_cast<std::uint8_t*>(id.data())));
+}
+
+bool CompareEntryIds(IMsgStore* store, const response::IdType& lhs, const response::IdType& rhs)
+{
+	ULONG result = 0;
+
+	return SUCCEEDED(store->CompareEntryIDs(static_cast<ULONG>(lhs.size()),
+			   reinterpret_cast<LPENTRYID>(const_cast<std::uint8_t*>(lhs.data())),
+			   static_cast<ULONG>(rhs.size()),
+			   reinterpret_cast<LPENTRYID>(const_cast<std::uint8_t*>(rhs.data())),
+			   0,
+			   &result))
+		&& result != 0;
+}
+
+} // namespace
+
+ObjectNotificationDispatcher::ObjectNotificationDispatcher(IMsgStore* store)
+	: m_state { std::make_shared<State>() }
+{
+	m_state->store = store;
+
+	CComPtr<AdviseSinkProxy<IMsgStore>> sinkProxy;
+	ULONG_PTR connectionId = 0;
+
+	sinkProxy.Attach(new AdviseSinkProxy<IMsgStore>(
+		[state = m_state](size_t count, LPNOTIFICATION pNotifications) {
+			if (nullptr == pNotifications)
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Dispatch(*state, pNotifications[i]);
+			}
+		}));
+
+	// Advise on the whole store instead of each folder or table we have open.
+	CORt(store->Advise(0,
+		nullptr,
+		fnevObjectCreated | fnevObjectModified | fnevObjectMoved | fnevObjectCopied
+			| fnevObjectDeleted | fnevNewMail,
+		sinkProxy,
+		&connectionId));
+	sinkProxy->OnAdvise(store, connectionId);
+
+	m_sinkProxy = sinkProxy;
+}
+
+ObjectNotificationDispatcher::~ObjectNotificationDispatcher()
+{
+	if (m_sinkProxy)
+	{
+		m_sinkProxy->Unadvise();
+	}
+}
+
+size_t ObjectNotificationDispatcher::version() const noexcept
+{
+	return m_state->version;
+}
+
+std::shared_ptr<ObjectNotificationDispatcher::Listener> ObjectNotificationDispatcher::subscribe(
+	const response::IdType& parentId, ULONG objectType, Callback&& callback)
+{
+	return Add(m_state->listeners, parentId, objectType, std::move(callback));
+}
+
+std::shared_ptr<ObjectNotificationDispatcher::Listener> ObjectNotificationDispatcher::watch(
+	const response::IdType& entryId, ULONG objectType, Callback&& callback)
+{
+	return Add(m_state->watchers, entryId, objectType, std::move(callback));
+}
+
+std::shared_ptr<ObjectNotificationDispatcher::Listener> ObjectNotificationDispatcher::Add(
+	ListenerIndex& index, const response::IdType& id, ULONG objectType, Callback&& callback)
+{
+	auto listener = std::make_shared<Listener>(Listener { objectType, std::move(callback) });
+	auto key = NormalizeEntryId(id);
+	std::lock_guard lock { m_state->mutex };
+	auto& map = index.map;
+	auto [itr, itrEnd] = map.equal_range(key);
+
+	if (itr == itrEnd)
+	{
+		if (index.keys.size() >= c_maxRememberedIds)
+		{
+			// Start over with just the IDs which are still in the map.
+			index.keys.clear();
+			index.unmatched.clear();
+
+			for (auto itrKey = map.cbegin(); itrKey != map.cend();
+				 itrKey = map.upper_bound(itrKey->first))
+			{
+				index.keys.push_back(itrKey->first);
+			}
+		}
+
+		// The notifications which didn't match the older IDs only need to be compared with this
+		// one the next time they show up.
+		index.keys.push_back(key);
+	}
+
+	// Clean up the listeners which were released since the last time we looked at this object.
+	while (itr != itrEnd)
+	{
+		itr = itr->second.expired() ? map.erase(itr) : std::next(itr);
+	}
+
+	map.emplace(std::move(key), listener);
+
+	return listener;
+}
+
+void ObjectNotificationDispatcher::Dispatch(State& state, const NOTIFICATION& notif)
+{
+	std::vector<std::shared_ptr<Listener>> listeners;
+
+	// Count every notification, even if nobody is listening for that object.
+	++state.version;
+
+	switch (notif.ulEventType)
+	{
+		case fnevNewMail:
+			Collect(state,
+				state.listeners,
+				NormalizeEntryId(notif.info.newmail.cbParentID, notif.info.newmail.lpParentID),
+				MAPI_MESSAGE,
+				listeners);
+			break;
+
+		case fnevObjectCreated:
+		case fnevObjectModified:
+		case fnevObjectDeleted:
+			Collect(state,
+				state.listeners,
+				NormalizeEntryId(notif.info.obj.cbParentID, notif.info.obj.lpParentID),
+				notif.info.obj.ulObjType,
+				listeners);
+
+			if (notif.ulEventType == fnevObjectModified)
+			{
+				Collect(state,
+					state.watchers,
+					NormalizeEntryId(notif.info.obj.cbEntryID, notif.info.obj.lpEntryID),
+					notif.info.obj.ulObjType,
+					listeners);
+			}
+			break;
+
+		case fnevObjectMoved:
+		case fnevObjectCopied:
+			// The object is added to the new parent, and a move also removes it from the old one.
+			Collect(state,
+				state.listeners,
+				NormalizeEntryId(notif.info.obj.cbParentID, notif.info.obj.lpParentID),
+				notif.info.obj.ulObjType,
+				listeners);
+
+			if (notif.ulEventType == fnevObjectMoved)
+			{
+				Collect(state,
+					state.listeners,
+					NormalizeEntryId(notif.info.obj.cbOldParentID, notif.info.obj.lpOldParentID),
+					notif.info.obj.ulObjType,
+					listeners);
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	// Invoke the callbacks without holding the lock, they may subscribe again.
+	for (const auto& listener : listeners)
+	{
+		listener->callback(notif);
+	}
+}
+
+void ObjectNotificationDispatcher::Collect(State& state, ListenerIndex& index,
+	const response::IdType& id, ULONG objectType, std::vector<std::shared_ptr<Listener>>& listeners)
+{
+	if (id.empty())
+	{
+		return;
+	}
+
+	std::unique_lock lock { state.mutex };
+	auto& map = index.map;
+	auto key = id;
+
+	if (map.find(key) == map.end())
+	{
+		if (const auto itrAlias = index.aliases.find(id); itrAlias != index.aliases.end())
+		{
+			key = itrAlias->second;
+		}
+	}
+
+	if (map.find(key) == map.end())
+	{
+		// Compare it with the IDs which were added since the last time we looked for it, without
+		// holding the lock, since each of them is a call to the store.
+		const auto itrUnmatched = index.unmatched.find(id);
+		const size_t compared = itrUnmatched == index.unmatched.end() ? 0 : itrUnmatched->second;
+
+		if (compared >= index.keys.size())
+		{
+			return;
+		}
+
+		const std::vector<response::IdType> keys { index.keys.cbegin() + compared,
+			index.keys.cend() };
+		const size_t generation = index.keys.size();
+
+		lock.unlock();
+
+		const auto itrKey =
+			std::find_if(keys.cbegin(), keys.cend(), [&state, &id](const auto& candidate) {
+				return CompareEntryIds(state.store, id, candidate);
+			});
+
+		lock.lock();
+
+		if (itrKey == keys.cend())
+		{
+			if (index.unmatched.size() >= c_maxRememberedIds)
+			{
+				index.unmatched.clear();
+			}
+
+			// If the keys started over while we were comparing them, this might skip some of them
+			// until the next time they start over. That only misses a notification which was
+			// already going to be missed by the exact comparison.
+			index.unmatched[id] = std::min(generation, index.keys.size());
+			return;
+		}
+
+		if (index.aliases.size() >= c_maxRememberedIds)
+		{
+			index.aliases.clear();
+		}
+
+		key = *itrKey;
+		index.aliases[id] = key;
+		index.unmatched.erase(id);
+	}
+
+	auto [itr, itrEnd] = map.equal_range(key);
+
+	while (itr != itrEnd)
+	{
+		auto listener = itr->second.lock();
+
+		if (!listener)
+		{
+			itr = map.erase(itr);
+			continue;
+		}
+
+		if (listener->objectType == objectType)
+		{
+			listeners.push_back(std::move(listener));
+		}
+
+		++itr;
+	}
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
@@ -225,138 +225,137 @@ std::vector<std::pair<ULONG, LPMAPINAMEID>> LookupPropIds(
 	return result;
 }
 
-std::vector<std::shared_ptr<object::Property>> GetProperties(
-	IMAPIProp* pObject, NameIdToPropId& nameIdMap, std::optional<std::vector<Column>>&& idsArg)
-{
-	constexpr std::array c_propTypes {
-				PT_LONG,
-				PT_BOOLEAN,
-				PT_UNICODE,
-				PT_CLSID,
-				PT_SYSTIME,
-				PT_BINARY,
-			};
-
-	std::map<ULONG, Property::id_variant> idMap;
-	ULONG cValues = 0;
-	mapi_ptr<SPropValue> props;
-	LPSPropValue propBegin = nullptr;
-	LPSPropValue propEnd = nullptr;
+namespace {
 
-	if (idsArg && !idsArg->empty())
-	{
-		// Only get selected properties.
-		std::vector<PropIdInput> inputs(idsArg->size());
+constexpr std::array c_propTypes {
+	PT_LONG,
+	PT_BOOLEAN,
+	PT_UNICODE,
+	PT_CLSID,
+	PT_SYSTIME,
+	PT_BINARY,
+};
 
-		std::transform(idsArg->cbegin(),
-			idsArg->cend(),
-			inputs.begin(),
-			[](const Column& column) noexcept {
-				return column.property;
-			});
+} // namespace
 
-		auto resolved = LookupPropIdInputs(pObject, nameIdMap, std::move(inputs));
+ResolvedColumns ResolveColumns(
+	IMAPIProp* pObject, NameIdToPropId& nameIdMap, const std::vector<Column>& columns)
+{
+	ResolvedColumns result;
+	std::vector<PropIdInput> inputs(columns.size());
+
+	std::transform(columns.cbegin(),
+		columns.cend(),
+		inputs.begin(),
+		[](const Column& column) noexcept {
+			return column.property;
+		});
 
-		CFRt(resolved.size() == idsArg->size());
+	auto resolved = LookupPropIdInputs(pObject, nameIdMap, std::move(inputs));
 
-		mapi_ptr<SPropTagArray> propIds;
+	CFRt(resolved.size() == columns.size());
 
-		CORt(::MAPIAllocateBuffer(CbNewSPropTagArray(static_cast<ULONG>(resolved.size())),
-			reinterpret_cast<void**>(&out_ptr { propIds })));
-		CFRt(propIds != nullptr);
-		propIds->cValues = static_cast<ULONG>(resolved.size());
+	CORt(::MAPIAllocateBuffer(CbNewSPropTagArray(static_cast<ULONG>(resolved.size())),
+		reinterpret_cast<void**>(&out_ptr { result.propTags })));
+	CFRt(result.propTags != nullptr);
+	result.propTags->cValues = static_cast<ULONG>(resolved.size());
 
-		for (size_t i = 0; i < resolved.size(); ++i)
-		{
-			CFRt(static_cast<size_t>(idsArg->at(i).type) < c_propTypes.size());
+	for (size_t i = 0; i < resolved.size(); ++i)
+	{
+		CFRt(static_cast<size_t>(columns[i].type) < c_propTypes.size());
 
-			const auto& entry = resolved[i];
-			const auto propType = c_propTypes[static_cast<size_t>(idsArg->at(i).type)];
-			const ULONG propId = PROP_ID(entry.first);
-			const LPMAPINAMEID name = entry.second;
+		const auto& entry = resolved[i];
+		const auto propType = c_propTypes[static_cast<size_t>(columns[i].type)];
+		const ULONG propId = PROP_ID(entry.first);
+		const LPMAPINAMEID name = entry.second;
 
-			propIds->aulPropTag[i] = PROP_TAG(propType, propId);
+		result.propTags->aulPropTag[i] = PROP_TAG(propType, propId);
 
-			if (name == nullptr)
-			{
-				idMap[propId] = propId;
-			}
-			else
-			{
-				idMap[propId] = *name;
-			}
+		if (name == nullptr)
+		{
+			result.idMap[propId] = propId;
+		}
+		else
+		{
+			result.idMap[propId] = *name;
 		}
-
-		// Get the props
-		LPSPropValue values = nullptr;
-
-		CORt(pObject->GetProps(propIds.get(), MAPI_UNICODE, &cValues, &values));
-		CFRt(values != nullptr);
-		CFRt(cValues > 0);
-		props.reset(values);
-		propBegin = props.get();
-		propEnd = propBegin + static_cast<size_t>(cValues);
 	}
-	else
-	{
-		// Get all of the properties.
-		LPSPropValue values = nullptr;
-
-		CORt(pObject->GetProps(nullptr, MAPI_UNICODE, &cValues, &values));
-		CFRt(values != nullptr);
-		CFRt(cValues > 0);
-		props.reset(values);
-		propBegin = props.get();
-		propEnd = propBegin + static_cast<size_t>(cValues);
 
-		std::vector<ULONG> propIds(static_cast<size_t>(cValues));
+	return result;
+}
 
-		std::transform(propBegin, propEnd, propIds.begin(), [](const SPropValue& value) noexcept {
-			return value.ulPropTag;
-		});
+std::map<ULONG, Property::id_variant> MapPropIds(
+	IMAPIProp* pObject, NameIdToPropId& nameIdMap, const std::vector<ULONG>& propIds)
+{
+	std::map<ULONG, Property::id_variant> idMap;
+	auto resolved = LookupPropIds(pObject, nameIdMap, propIds);
 
-		auto resolved = LookupPropIds(pObject, nameIdMap, propIds);
+	for (const auto& entry : resolved)
+	{
+		const ULONG propId = PROP_ID(entry.first);
+		const LPMAPINAMEID name = entry.second;
 
-		for (const auto& entry : resolved)
+		if (name == nullptr)
 		{
-			const ULONG propId = PROP_ID(entry.first);
-			const LPMAPINAMEID name = entry.second;
-
-			if (name == nullptr)
-			{
-				idMap[propId] = propId;
-			}
-			else
-			{
-				idMap[propId] = *name;
-			}
+			idMap[propId] = propId;
+		}
+		else
+		{
+			idMap[propId] = *name;
 		}
 	}
 
-	// Double check that we mapped all of the property IDs.
-	CFRt(idMap.size() == static_cast<size_t>(cValues));
+	return idMap;
+}
+
+std::vector<std::shared_ptr<object::Property>> GetColumnProperties(
+	IMAPIProp* pObject, const ResolvedColumns& resolved, const std::vector<Column>& columns)
+{
+	ULONG cValues = 0;
+	LPSPropValue values = nullptr;
+
+	CORt(pObject->GetProps(resolved.propTags.get(), MAPI_UNICODE, &cValues, &values));
+	CFRt(values != nullptr);
+	CFRt(cValues > 0);
+
+	const mapi_ptr<SPropValue> props { values };
 
+	return ConvertProperties(pObject, resolved.idMap, &columns, props.get(), cValues);
+}
+
+std::vector<std::shared_ptr<object::Property>> ConvertProperties(IMAPIProp* pObject,
+	const std::map<ULONG, Property::id_variant>& idMap, const std::vector<Column>* columns,
+	const SPropValue* values, size_t count)
+{
 	// Split the values allocation into a separate buffer for each property and build the result vector.
-	std::vector<std::shared_ptr<object::Property>> result(cValues);
+	std::vector<std::shared_ptr<object::Property>> result(count);
 
-	for (size_t i = 0; i < cValues; ++i)
+	for (size_t i = 0; i < count; ++i)
 	{
-		auto& prop = props.get()[i];
+		auto& prop = const_cast<SPropValue&>(values[i]);
 		const ULONG propId = PROP_ID(prop.ulPropTag);
-	
-		if (idsArg && !idsArg->empty() && PROP_TYPE(prop.ulPropTag) == PT_ERROR && prop.Value.err == MAPI_E_NOT_ENOUGH_MEMORY)
+		const auto itr = idMap.find(propId);
+
+		// Double check that we mapped all of the property IDs.
+		CFRt(itr != idMap.cend());
+
+		if (pObject && columns && PROP_TYPE(prop.ulPropTag) == PT_ERROR
+			&& prop.Value.err == MAPI_E_NOT_ENOUGH_MEMORY)
 		{
-			// We failed to get a property because it was too large, and we know the type the consumer wanted
-			// because they provided a list of properties. Try again with OpenProperty for their requested type.
+			// We failed to get a property because it was too large, and we know the type the
+			// consumer wanted because they provided a list of properties. Try again with
+			// OpenProperty for their requested type.
+			const auto propType = c_propTypes[static_cast<size_t>(columns->at(i).type)];
 			CComPtr<IStream> stream;
-			CORt(pObject->OpenProperty(PROP_TAG(c_propTypes[static_cast<size_t>(idsArg->at(i).type)], propId),
+
+			CORt(pObject->OpenProperty(PROP_TAG(propType, propId),
 				&IID_IStream,
 				STGM_READ,
 				0,
 				reinterpret_cast<LPUNKNOWN*>(&stream)));
 			
 			StreamEncoding encoding = StreamEncoding::unknown;
-			switch(idsArg->at(i).type)
+			switch(columns->at(i).type)
 			{
 				case PropType::BINARY:
 					encoding = StreamEncoding::binary;
@@ -367,7 +366,7 @@ std::vector<std::shared_ptr<object::Property>> GetProperties(
 			}
 
 			result[i] = std::make_shared<object::Property>(
-				std::make_shared<Property>(std::move(idMap[propId]), DataStream { std::move(stream), encoding }));
+				std::make_shared<Property>(itr->second, DataStream { std::move(stream), encoding }));
 		}
 		else
 		{
@@ -377,11 +376,76 @@ std::vector<std::shared_ptr<object::Property>> GetProperties(
 			CFRt(dupe != nullptr);
 
 			result[i] = std::make_shared<object::Property>(
-				std::make_shared<Property>(std::move(idMap[propId]), std::move(dupe)));
+				std::make_shared<Property>(itr->second, std::move(dupe)));
 		}
 	}
 
 	return result;
 }
 
+std::vector<std::shared_ptr<object::Property>> GetProperties(
+	IMAPIProp* pObject, NameIdToPropId& nameIdMap, std::optional<std::vector<Column>>&& idsArg)
+{
+	if (idsArg && !idsArg->empty())
+	{
+		// Only get selected properties.
+		const auto resolved = ResolveColumns(pObject, nameIdMap, *idsArg);
+
+		return GetColumnProperties(pObject, resolved, *idsArg);
+	}
+
+	// Get all of the properties.
+	ULONG cValues = 0;
+	LPSPropValue values = nullptr;
+
+	CORt(pObject->GetProps(nullptr, MAPI_UNICODE, &cValues, &values));
+	CFRt(values != nullptr);
+	CFRt(cValues > 0);
+
+	const mapi_ptr<SPropValue> props { values };
+	std::vector<ULONG> propIds(static_cast<size_t>(cValues));
+
+	std::transform(props.get(),
+		props.get() + cValues,
+		propIds.begin(),
+		[](const SPropValue& value) noexcept {
+			return value.ulPropTag;
+		});
+
+	const auto idMap = MapPropIds(pObject, nameIdMap, propIds);
+
+	return ConvertProperties(pObject, idMap, nullptr, props.get(), cValues);
+}
+
+std::vector<SPropValue> GetChangedColumns(size_t previousCount, const SPropValue* previous,
+	size_t currentCount, const SPropValue* current)
+{
+	std::vector<SPropValue> result;
+
+	// Rows from the same table have the same columns in the same order, so we can compare them
+	// pairwise. The values still point into the current row.
+	for (size_t i = 0; i < currentCount; ++i)
+	{
+		const auto& column = current[i];
+
+		if (i < previousCount && previous[i].ulPropTag == column.ulPropTag)
+		{
+			const bool unchanged = PROP_TYPE(column.ulPropTag) == PT_ERROR
+				? previous[i].Value.err == column.Value.err
+				: ::LPropCompareProp(const_cast<LPSPropValue>(previous + i),
+					  const_cast<LPSPropValue>(&column))
+					== 0;
+
+			if (unchanged)
+			{
+				continue;
+			}
+		}
+
+		result.push_back(column);
+	}
+
+	return result;
+}
+
 } // namespace graphql::mapi::prop
\ No newline at end of file
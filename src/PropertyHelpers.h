@@ -11,4 +11,30 @@ std::vector<std::pair<ULONG, LPMAPINAMEID>> LookupPropIds(
 std::vector<std::shared_ptr<object::Property>> GetProperties(
 	IMAPIProp* pObject, NameIdToPropId& nameIdMap, std::optional<std::vector<Column>>&& idsArg);
 
+// Property tags for a list of columns, resolved once so they can be read from many objects.
+struct ResolvedColumns
+{
+	mapi_ptr<SPropTagArray> propTags;
+	std::map<ULONG, Property::id_variant> idMap;
+};
+
+ResolvedColumns ResolveColumns(
+	IMAPIProp* pObject, NameIdToPropId& nameIdMap, const std::vector<Column>& columns);
+
+// Map the property tags from GetProps(nullptr) on any number of objects to their IDs or names.
+std::map<ULONG, Property::id_variant> MapPropIds(
+	IMAPIProp* pObject, NameIdToPropId& nameIdMap, const std::vector<ULONG>& propIds);
+
+std::vector<std::shared_ptr<object::Property>> GetColumnProperties(
+	IMAPIProp* pObject, const ResolvedColumns& resolved, const std::vector<Column>& columns);
+
+// Convert property values which were already read into properties. If the columns are specified
+// and there's an object, values which were too large to read are opened as streams instead.
+std::vector<std::shared_ptr<object::Property>> ConvertProperties(IMAPIProp* pObject,
+	const std::map<ULONG, Property::id_variant>& idMap, const std::vector<Column>* columns,
+	const SPropValue* values, size_t count);
+
+std::vector<SPropValue> GetChangedColumns(size_t previousCount, const SPropValue* previous,
+	size_t currentCount, const SPropValue* current);
+
 } // namespace graphql::mapi
\ No newline at end of file
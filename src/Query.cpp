@@ -12,13 +12,33 @@
 
 namespace graphql::mapi {
 
-Query::Query(const std::shared_ptr<Session>& session)
+Query::Query(const std::shared_ptr<Session>& session, const ServiceOptions& options)
 	: m_session { session }
+	, m_hierarchyOptions { options.hierarchy }
+	, m_tableOptions { options.tables }
+	, m_executor { std::make_shared<StoreExecutor>(options.executor) }
+	, m_stores { options.tables.windows }
+	, m_responses { options.responseCache.capacity > 0
+			? std::make_shared<ResponseCache>(options.responseCache)
+			: nullptr }
 {
 }
 
 Query::~Query()
 {
+	if (m_warmUpThread.joinable())
+	{
+		if (m_warmUpThread.get_id() == std::this_thread::get_id())
+		{
+			// The warm-up thread released the last reference, it will exit as soon as we return.
+			m_warmUpThread.detach();
+		}
+		else
+		{
+			m_warmUpThread.join();
+		}
+	}
+
 	// Release all of the MAPI objects we opened and free any MAPI memory allocations.
 	if (m_storeSink)
 	{
@@ -29,54 +49,202 @@ Query::~Query()
 	m_session.reset();
 }
 
-const std::vector<std::shared_ptr<Store>>& Query::stores()
+std::shared_ptr<const std::vector<std::shared_ptr<Store>>> Query::stores()
 {
-	LoadStores({});
-	return *m_stores;
+	WaitForWarmUp();
+
+	auto stores = LoadStores({});
+
+	return { stores, &stores->rows };
 }
 
 std::shared_ptr<Store> Query::lookup(const response::IdType& id)
 {
-	LoadStores({});
+	WaitForWarmUp();
+	return LoadStores({})->find(id);
+}
+
+void Query::warmUp(WarmUpPolicy policy)
+{
+	if (policy == WarmUpPolicy::None || m_warmUpThread.joinable())
+	{
+		return;
+	}
+
+	std::promise<void> warmedUp;
+
+	m_warmUp = warmedUp.get_future().share();
+	m_warmUpThread = std::thread(
+		[spThis = shared_from_this(), policy, warmedUp = std::move(warmedUp)]() mutable {
+			const MAPIThreadScope scope;
+
+			if (scope)
+			{
+				try
+				{
+					spThis->WarmUp(policy);
+				}
+				catch (const std::exception&)
+				{
+					// CORt and CFRt already reported the error, the requests will load whatever
+					// is missing.
+				}
+			}
+
+			warmedUp.set_value();
 
-	auto itr = m_ids->find(id);
+			// If this is the last reference, release the MAPI objects before the scope ends.
+			spThis.reset();
+		});
+}
 
-	if (itr == m_ids->cend())
+void Query::WarmUp(WarmUpPolicy policy)
+{
+	for (const auto& store : LoadStores({})->rows)
 	{
-		return nullptr;
+		store->store();
+
+		if (policy == WarmUpPolicy::Folders)
+		{
+			store->rootFolders();
+			store->specialFolders();
+		}
 	}
+}
 
-	return m_stores->at(itr->second);
+void Query::WaitForWarmUp() const
+{
+	if (m_warmUp.valid())
+	{
+		m_warmUp.wait();
+	}
 }
 
 void Query::ClearCaches()
 {
-	if (m_stores)
+	// Don't let the warm-up thread cache anything else after we clear them.
+	WaitForWarmUp();
+
+	for (const auto& stores : m_stores.snapshots())
 	{
-		for (const auto& entry : *m_stores)
+		for (const auto& entry : stores->rows)
 		{
 			entry->ClearCaches();
 		}
 	}
 }
 
-void Query::LoadStores(service::Directives&& fieldDirectives)
+const std::shared_ptr<ResponseCache>& Query::responses() const noexcept
 {
-	if (m_storeDirectives != fieldDirectives)
+	return m_responses;
+}
+
+ResponseVersions Query::captureVersions() const
+{
+	ResponseVersions versions { m_responseVersion };
+
+	for (const auto& stores : m_stores.snapshots())
 	{
-		// Reset the stores and reload if the directives change
-		m_stores.reset();
-		m_storeDirectives = std::move(fieldDirectives);
+		for (const auto& store : stores->rows)
+		{
+			versions.stores.emplace_back(store, store->version());
+		}
 	}
 
-	if (m_stores)
+	return versions;
+}
+
+std::optional<ResponseVersions> Query::verifyVersions(const ResponseVersions& before) const
+{
+	const auto snapshots = m_stores.snapshots();
+
+	if (snapshots.empty() || m_responseVersion != before.query)
 	{
-		return;
+		return std::nullopt;
 	}
 
-	m_ids = std::make_unique<std::map<response::IdType, size_t>>();
-	m_stores = std::make_unique<std::vector<std::shared_ptr<Store>>>();
+	ResponseVersions after { before.query };
+	bool unchanged = true;
+
+	for (const auto& stores : snapshots)
+	{
+		for (const auto& store : stores->rows)
+		{
+			if (!store->opened())
+			{
+				// Nothing was read from it.
+				continue;
+			}
+
+			const auto itr = std::find_if(before.stores.cbegin(),
+				before.stores.cend(),
+				[&store](const auto& entry) noexcept {
+					return entry.first.lock() == store;
+				});
+			const auto version = store->version();
+
+			if (itr == before.stores.cend() || !itr->second || version != itr->second)
+			{
+				unchanged = false;
+
+				if (!version)
+				{
+					// Start listening for changes, so the next response from it can be cached.
+					try
+					{
+						store->notifications();
+					}
+					catch (const std::exception&)
+					{
+						// CORt and CFRt already reported the error, it will try again next time.
+					}
+				}
+
+				continue;
+			}
+
+			after.stores.emplace_back(store, version);
+		}
+	}
+
+	if (!unchanged)
+	{
+		return std::nullopt;
+	}
+
+	return after;
+}
+
+bool Query::isCurrent(const ResponseVersions& versions) const
+{
+	return m_responseVersion == versions.query
+		&& std::all_of(versions.stores.cbegin(),
+			versions.stores.cend(),
+			[](const auto& entry) {
+				const auto store = entry.first.lock();
+
+				return store && store->version() == entry.second;
+			});
+}
 
+void Query::invalidateResponses() noexcept
+{
+	++m_responseVersion;
+}
+
+std::shared_ptr<const StoreSnapshot> Query::LoadStores(
+	const service::Directives& fieldDirectives)
+{
+	// Keep a window for each set of table directives.
+	const TableDirectives directives { {}, fieldDirectives };
+
+	return m_stores.load(directives.canonicalKey(), [this, &directives](StoreSnapshot& snapshot) {
+		ReadStores(directives, snapshot);
+	});
+}
+
+void Query::ReadStores(const TableDirectives& directives, StoreSnapshot& snapshot)
+{
 	// Enumerate the message stores table and fill in the Store object collection.
 	constexpr auto c_storeProps = Store::GetStoreColumns();
 	mapi_ptr<SPropTagArray> storeProps;
@@ -98,7 +266,6 @@ void Query::LoadStores(service::Directives&& fieldDirectives)
 	storeSorts->cExpanded = 0;
 	std::copy(c_storeSorts.begin(), c_storeSorts.end(), storeSorts->aSort);
 
-	const TableDirectives directives { {}, m_storeDirectives };
 	CComPtr<IMAPITable> sptable;
 
 	CORt(m_session->session()->GetMsgStoresTable(0, &sptable));
@@ -106,7 +273,7 @@ void Query::LoadStores(service::Directives&& fieldDirectives)
 	const rowset_ptr sprows =
 		directives.read(sptable, std::move(storeProps), std::move(storeSorts));
 
-	m_stores->reserve(static_cast<size_t>(sprows->cRows));
+	snapshot.rows.reserve(static_cast<size_t>(sprows->cRows));
 	for (ULONG i = 0; i != sprows->cRows; i++)
 	{
 		auto& row = sprows->aRow[i];
@@ -115,10 +282,21 @@ void Query::LoadStores(service::Directives&& fieldDirectives)
 
 		row.lpProps = nullptr;
 
-		auto store = std::make_shared<Store>(m_session->session(), columnCount, std::move(columns));
+		auto store = std::make_shared<Store>(m_session->session(),
+			columnCount,
+			std::move(columns),
+			m_hierarchyOptions,
+			m_tableOptions,
+			m_executor);
+
+		if (!m_session->profile().empty())
+		{
+			// Use the same store as the other services on this profile, along with its caches.
+			store = SharedStores::instance().share(
+				m_session->profile(), std::move(store), shared_from_this());
+		}
 
-		m_ids->insert(std::make_pair(store->id(), m_stores->size()));
-		m_stores->push_back(std::move(store));
+		snapshot.append(std::move(store));
 	}
 
 	if (!m_storeSink)
@@ -133,6 +311,7 @@ void Query::LoadStores(service::Directives&& fieldDirectives)
 
 				if (spQuery)
 				{
+					++spQuery->m_responseVersion;
 					spQuery->m_stores.reset();
 				}
 			}));
@@ -146,22 +325,48 @@ void Query::LoadStores(service::Directives&& fieldDirectives)
 
 void Query::endSelectionSet(const service::SelectionSetParams&)
 {
-	ClearCaches();
+	// Don't let the warm-up thread cache anything else after we clear them.
+	WaitForWarmUp();
+
+	const auto spThis = shared_from_this();
+	const auto& profile = m_session->profile();
+	auto& sharedStores = SharedStores::instance();
+
+	for (const auto& stores : m_stores.snapshots())
+	{
+		for (const auto& entry : stores->rows)
+		{
+			// Only the service which owns a shared store clears it after each query, so the other
+			// services don't empty its caches in the middle of their own queries.
+			if (profile.empty() || sharedStores.owns(profile, *entry, spThis))
+			{
+				entry->ClearCaches();
+			}
+		}
+	}
 }
 
-std::vector<std::shared_ptr<object::Store>> Query::getStores(
-	service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Store>>> Query::getStores(
+	service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg)
 {
+	const auto spThis = shared_from_this();
+	const auto fieldDirectives = std::move(params.fieldDirectives);
+
+	// The message stores table belongs to the session, so it gets its own key.
+	co_await m_executor->schedule(this);
+
 	std::vector<std::shared_ptr<object::Store>> result {};
 
-	LoadStores(std::move(params.fieldDirectives));
+	WaitForWarmUp();
+
+	const auto stores = LoadStores(fieldDirectives);
 
 	if (idsArg)
 	{
         // Error out if caller requested a non-existent store
         for (const auto& id : idsArg.value())
         {
-            if (!lookup(id))
+            if (!stores->find(id))
                 throw std::exception(std::format("Store not found with id=\"{}\"", id.c_str()).c_str());
         }
 
@@ -170,23 +375,23 @@ std::vector<std::shared_ptr<object::Store>> Query::getStores(
 		std::transform(idsArg->cbegin(),
 			idsArg->cend(),
 			result.begin(),
-			[this](const response::IdType& id) noexcept {
-				return std::make_shared<object::Store>(lookup(id));
+			[&stores](const response::IdType& id) noexcept {
+				return std::make_shared<object::Store>(stores->find(id));
 			});
 	}
 	else
 	{
 		// Just clone the entire vector of stores.
-		result.resize(m_stores->size());
-		std::transform(m_stores->cbegin(),
-			m_stores->cend(),
+		result.resize(stores->rows.size());
+		std::transform(stores->rows.cbegin(),
+			stores->rows.cend(),
 			result.begin(),
 			[this](const std::shared_ptr<Store>& store) noexcept {
 				return std::make_shared<object::Store>(store);
 			});
 	}
 
-	return result;
+	co_return result;
 }
 
 std::vector<std::shared_ptr<object::Property>> Query::getMsgFileData(
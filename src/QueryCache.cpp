@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "QueryCache.h"
+
+#include "Sha256.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace graphql::mapi {
+
+QueryCache::QueryCache(size_t capacity)
+	: m_metrics { std::make_shared<QueryCacheMetrics>() }
+	, m_capacity { capacity }
+{
+}
+
+QueryCache& QueryCache::instance()
+{
+	static QueryCache s_instance;
+
+	return s_instance;
+}
+
+void QueryCache::setCapacity(size_t capacity)
+{
+	std::lock_guard lock { m_mutex };
+
+	m_capacity = capacity;
+	Evict();
+}
+
+std::shared_ptr<const QueryCacheMetrics> QueryCache::metrics() const noexcept
+{
+	return m_metrics;
+}
+
+std::shared_ptr<peg::ast> QueryCache::parse(const service::Request& request,
+	std::string_view query, std::string_view operationName, std::string_view persistedId)
+{
+	// The cache is shared by every service in the process, so only bind a persisted ID to the
+	// query it's the SHA-256 digest of, otherwise another caller could rebind it to its own query.
+	if (!persistedId.empty() && !IsQueryDigest(query, persistedId))
+	{
+		throw service::schema_exception { { "Persisted query ID does not match the query" } };
+	}
+
+	const auto hash = Hash(query, operationName);
+
+	{
+		std::lock_guard lock { m_mutex };
+		const auto itr = Find(hash, query, operationName);
+
+		if (itr != m_entries.end())
+		{
+			++m_metrics->hits;
+			m_entries.splice(m_entries.begin(), m_entries, itr);
+			Persist(itr, persistedId);
+			return itr->ast;
+		}
+	}
+
+	++m_metrics->misses;
+
+	// Parse and validate it without holding the lock, so other queries aren't blocked.
+	auto ast = std::make_shared<peg::ast>(peg::parseString(query));
+	auto errors = request.validate(*ast);
+
+	if (!errors.empty())
+	{
+		throw service::schema_exception { std::move(errors) };
+	}
+
+	std::lock_guard lock { m_mutex };
+
+	if (m_capacity == 0)
+	{
+		return ast;
+	}
+
+	// Another thread may have cached the same query while we were parsing it.
+	auto itr = Find(hash, query, operationName);
+
+	if (itr == m_entries.end())
+	{
+		m_entries.push_front(Entry {
+			hash,
+			std::string { query },
+			std::string { operationName },
+			{},
+			std::move(ast),
+		});
+		itr = m_entries.begin();
+		m_hashes.emplace(hash, itr);
+	}
+	else
+	{
+		m_entries.splice(m_entries.begin(), m_entries, itr);
+	}
+
+	Persist(itr, persistedId);
+	Evict();
+
+	return itr->ast;
+}
+
+std::shared_ptr<peg::ast> QueryCache::find(
+	std::string_view persistedId, std::string_view operationName)
+{
+	const PersistedKey key { std::string { persistedId }, std::string { operationName } };
+	std::lock_guard lock { m_mutex };
+	const auto itr = m_persisted.find(key);
+
+	if (itr == m_persisted.end())
+	{
+		++m_metrics->persistedMisses;
+		return nullptr;
+	}
+
+	++m_metrics->persistedHits;
+	m_entries.splice(m_entries.begin(), m_entries, itr->second);
+
+	return itr->second->ast;
+}
+
+size_t QueryCache::Hash(std::string_view query, std::string_view operationName) noexcept
+{
+	const std::hash<std::string_view> hasher {};
+	const auto queryHash = hasher(query);
+
+	return queryHash ^ (hasher(operationName) + 0x9e3779b9 + (queryHash << 6) + (queryHash >> 2));
+}
+
+bool QueryCache::IsQueryDigest(std::string_view query, std::string_view persistedId)
+{
+	return convert::sha256::to_hex(query) == persistedId;
+}
+
+QueryCache::EntryList::iterator QueryCache::Find(
+	size_t hash, std::string_view query, std::string_view operationName)
+{
+	// Compare the text too, so a hash collision is just a miss.
+	const auto [begin, end] = m_hashes.equal_range(hash);
+	const auto itr = std::find_if(begin, end, [query, operationName](const auto& entry) noexcept {
+		return entry.second->query == query && entry.second->operationName == operationName;
+	});
+
+	return itr == end ? m_entries.end() : itr->second;
+}
+
+void QueryCache::Persist(EntryList::iterator itr, std::string_view persistedId)
+{
+	if (persistedId.empty())
+	{
+		return;
+	}
+
+	PersistedKey key { std::string { persistedId }, itr->operationName };
+	auto [persisted, inserted] = m_persisted.emplace(key, itr);
+
+	if (!inserted)
+	{
+		// The ID is the digest of the query text, so it's already bound to this entry.
+		return;
+	}
+
+	itr->persistedIds.push_back(std::move(key.first));
+}
+
+void QueryCache::Erase(EntryList::iterator itr)
+{
+	for (auto& persistedId : itr->persistedIds)
+	{
+		m_persisted.erase(PersistedKey { std::move(persistedId), itr->operationName });
+	}
+
+	const auto [begin, end] = m_hashes.equal_range(itr->hash);
+
+	for (auto hashItr = begin; hashItr != end; ++hashItr)
+	{
+		if (hashItr->second == itr)
+		{
+			m_hashes.erase(hashItr);
+			break;
+		}
+	}
+
+	m_entries.erase(itr);
+}
+
+void QueryCache::Evict()
+{
+	while (m_entries.size() > m_capacity)
+	{
+		++m_metrics->evictions;
+		Erase(std::prev(m_entries.end()));
+	}
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ServiceOptions.h"
+
+#include "graphqlservice/GraphQLParse.h"
+#include "graphqlservice/GraphQLService.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graphql::mapi {
+
+// Queries which were already parsed and validated, keyed by a hash of the query text and the
+// operation name, and kept in LRU order. Validation sets peg::ast::validated, so the service skips
+// it when it resolves a cached AST, and nothing else modifies it, so concurrent requests can
+// resolve the same AST.
+class QueryCache
+{
+public:
+	explicit QueryCache(size_t capacity = QueryCacheOptions {}.capacity);
+
+	// The cache which is shared by every service in the process.
+	static QueryCache& instance();
+
+	void setCapacity(size_t capacity);
+	std::shared_ptr<const QueryCacheMetrics> metrics() const noexcept;
+
+	// Return the cached AST, or parse and validate the query and cache that. An optional persisted
+	// query ID lets find return it later without the query text. It must be the lowercase hex
+	// SHA-256 digest of the query, and this throws if it doesn't match or the query is invalid.
+	std::shared_ptr<peg::ast> parse(const service::Request& request, std::string_view query,
+		std::string_view operationName, std::string_view persistedId = {});
+
+	// Find a query by the persisted ID it was parsed with, or nullptr if it isn't cached.
+	std::shared_ptr<peg::ast> find(std::string_view persistedId, std::string_view operationName);
+
+private:
+	struct Entry
+	{
+		size_t hash;
+		std::string query;
+		std::string operationName;
+		std::vector<std::string> persistedIds;
+		std::shared_ptr<peg::ast> ast;
+	};
+
+	using EntryList = std::list<Entry>;
+	using PersistedKey = std::pair<std::string, std::string>;
+
+	static size_t Hash(std::string_view query, std::string_view operationName) noexcept;
+	static bool IsQueryDigest(std::string_view query, std::string_view persistedId);
+
+	// These must be called while holding m_mutex.
+	EntryList::iterator Find(size_t hash, std::string_view query, std::string_view operationName);
+	void Persist(EntryList::iterator itr, std::string_view persistedId);
+	void Erase(EntryList::iterator itr);
+	void Evict();
+
+	const std::shared_ptr<QueryCacheMetrics> m_metrics;
+
+	std::mutex m_mutex;
+	size_t m_capacity;
+
+	// The most recently used entries are at the front.
+	EntryList m_entries;
+	std::unordered_multimap<size_t, EntryList::iterator> m_hashes;
+	std::map<PersistedKey, EntryList::iterator> m_persisted;
+};
+
+} // namespace graphql::mapi
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "QueryCache.h"
+#include "Types.h"
+
+#include "graphqlservice/JSONResponse.h"
+
+#include "graphqlservice/internal/Grammar.h"
+
+using namespace std::literals;
+
+namespace graphql::mapi {
+
+ResponseCache::ResponseCache(const ResponseCacheOptions& options)
+	: m_capacity { options.capacity }
+	, m_metrics { options.metrics ? options.metrics : std::make_shared<ResponseCacheMetrics>() }
+{
+}
+
+std::string ResponseCache::resolve(Query& query, service::Request& request,
+	std::string_view queryText, std::string_view operationName, const response::Value& variables)
+{
+	std::string key { queryText };
+
+	key.push_back('\0');
+	key.append(operationName);
+	key.push_back('\0');
+	key.append(response::toJSON(response::Value { variables }));
+
+	if (auto json = Find(query, key))
+	{
+		return std::move(*json);
+	}
+
+	const auto ast = QueryCache::instance().parse(request, queryText, operationName);
+	const bool cacheable =
+		request.findOperationDefinition(*ast, operationName).first == service::strQuery
+		&& ReadsOnlyStores(*ast);
+
+	// Capture the versions before reading anything, so changes while it's resolving are caught.
+	const auto before = query.captureVersions();
+	auto document = request.resolve({ *ast, operationName, response::Value { variables } }).get();
+	const bool failed = document.find(service::strErrors) != document.end();
+	auto json = response::toJSON(std::move(document));
+
+	if (cacheable && !failed)
+	{
+		if (auto versions = query.verifyVersions(before))
+		{
+			Insert(std::move(key), json, std::move(*versions));
+		}
+	}
+
+	return json;
+}
+
+bool ResponseCache::ReadsOnlyStores(const peg::ast& ast)
+{
+	// Check every field in the document, including the fragments and any other operations. That
+	// might skip caching a response which could have been cached, but never the other way around.
+	std::vector<const peg::ast_node*> nodes { ast.root.get() };
+
+	while (!nodes.empty())
+	{
+		const auto node = nodes.back();
+
+		nodes.pop_back();
+
+		if (node->is_type<peg::field_name>() && node->string_view() == "msgFileData"sv)
+		{
+			return false;
+		}
+
+		for (const auto& child : node->children)
+		{
+			nodes.push_back(child.get());
+		}
+	}
+
+	return true;
+}
+
+std::optional<std::string> ResponseCache::Find(Query& query, const std::string& key)
+{
+	std::lock_guard lock { m_mutex };
+	const auto itr = m_keys.find(key);
+
+	if (itr == m_keys.end())
+	{
+		++m_metrics->misses;
+		return std::nullopt;
+	}
+
+	const auto entry = itr->second;
+
+	if (!query.isCurrent(entry->versions))
+	{
+		++m_metrics->stale;
+		m_keys.erase(itr);
+		m_entries.erase(entry);
+		return std::nullopt;
+	}
+
+	++m_metrics->hits;
+	m_entries.splice(m_entries.begin(), m_entries, entry);
+
+	return entry->json;
+}
+
+void ResponseCache::Insert(std::string&& key, const std::string& json, ResponseVersions&& versions)
+{
+	std::lock_guard lock { m_mutex };
+
+	// Another request may have resolved the same query at the same time.
+	if (const auto itr = m_keys.find(key); itr != m_keys.end())
+	{
+		const auto entry = itr->second;
+
+		m_keys.erase(itr);
+		m_entries.erase(entry);
+	}
+
+	m_entries.push_front(Entry { std::move(key), json, std::move(versions) });
+	m_keys.emplace(m_entries.front().key, m_entries.begin());
+
+	while (m_entries.size() > m_capacity)
+	{
+		m_keys.erase(m_entries.back().key);
+		m_entries.pop_back();
+	}
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
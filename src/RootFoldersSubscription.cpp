@@ -7,8 +7,9 @@
 namespace graphql::mapi {
 
 RootFoldersSubscription::RootFoldersSubscription(
-	std::vector<std::shared_ptr<object::FolderChange>>&& rootFolders)
+	std::vector<std::shared_ptr<object::FolderChange>>&& rootFolders, std::optional<int> resumedFrom)
 	: m_rootFolders { std::move(rootFolders) }
+	, m_resumedFrom { resumedFrom }
 {
 }
 
@@ -25,9 +26,20 @@ std::vector<std::shared_ptr<object::FolderChange>> RootFoldersSubscription::getS
 }
 
 std::vector<std::shared_ptr<object::FolderChange>> RootFoldersSubscription::getRootFolders(
-	response::IdType&& storeIdArg) const
+	service::FieldParams&& params, response::IdType&& storeIdArg) const
 {
+	if (m_resumedFrom && Subscription::GetResumeDirective(params.fieldDirectives) != m_resumedFrom)
+	{
+		return {};
+	}
+
 	return m_rootFolders;
 }
 
+std::vector<std::shared_ptr<object::FolderCounts>> RootFoldersSubscription::getFolderCounts(
+	std::vector<ObjectId>&& folderIdsArg) const
+{
+	return {};
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
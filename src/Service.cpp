@@ -9,24 +9,102 @@
 #endif // !GQLMAPI_DLLEXPORTS
 // clang-format on
 
+#include "QueryCache.h"
 #include "Types.h"
 
 #include "MutationObject.h"
 #include "QueryObject.h"
 #include "SubscriptionObject.h"
 
+#include "graphqlservice/JSONResponse.h"
+
 namespace graphql::mapi {
 
-GQLMAPI_EXPORT std::shared_ptr<service::Request> GetService(bool useDefaultProfile) noexcept
+namespace {
+
+// GetService registers the Query behind each service with a response cache, so ResolveToJSON can
+// find it. They're keyed by the owner of the service, so a new service which happens to get the
+// same address as one which was released can't find the old Query.
+std::mutex s_cachedServicesMutex;
+std::map<std::weak_ptr<service::Request>, std::weak_ptr<Query>,
+	std::owner_less<std::weak_ptr<service::Request>>>
+	s_cachedServices;
+
+void RegisterCachedService(
+	const std::shared_ptr<service::Request>& request, const std::shared_ptr<Query>& query)
+{
+	std::lock_guard lock { s_cachedServicesMutex };
+
+	std::erase_if(s_cachedServices, [](const auto& entry) noexcept {
+		return entry.first.expired() || entry.second.expired();
+	});
+	s_cachedServices[request] = query;
+}
+
+std::shared_ptr<Query> FindCachedService(const std::shared_ptr<service::Request>& request)
+{
+	std::lock_guard lock { s_cachedServicesMutex };
+	const auto itr = s_cachedServices.find(request);
+
+	return itr == s_cachedServices.cend() ? nullptr : itr->second.lock();
+}
+
+} // namespace
+
+GQLMAPI_EXPORT std::shared_ptr<service::Request> GetService(
+	bool useDefaultProfile, const ServiceOptions& options) noexcept
 {
-	auto session = std::make_shared<Session>(useDefaultProfile);
-	auto query = std::make_shared<Query>(session);
+	auto session = Session::logon(useDefaultProfile);
+	auto query = std::make_shared<Query>(session, options);
 	auto mutation = std::make_shared<Mutation>(query);
-	auto subscription = std::make_shared<Subscription>(query);
+	auto subscription = std::make_shared<Subscription>(query, options.subscriptions);
 	auto service = std::make_shared<Operations>(query, mutation, subscription);
 
 	subscription->setService(service);
+
+	if (query->responses())
+	{
+		RegisterCachedService(service, query);
+	}
+
+	query->warmUp(options.warmUp);
 	return service;
 }
 
+GQLMAPI_EXPORT std::shared_ptr<peg::ast> ParseQuery(const service::Request& service,
+	std::string_view query, std::string_view operationName, std::string_view persistedId)
+{
+	return QueryCache::instance().parse(service, query, operationName, persistedId);
+}
+
+GQLMAPI_EXPORT std::shared_ptr<peg::ast> FindPersistedQuery(
+	std::string_view persistedId, std::string_view operationName)
+{
+	return QueryCache::instance().find(persistedId, operationName);
+}
+
+GQLMAPI_EXPORT std::string ResolveToJSON(const std::shared_ptr<service::Request>& service,
+	std::string_view query, std::string_view operationName, const response::Value& variables)
+{
+	if (const auto spQuery = FindCachedService(service))
+	{
+		return spQuery->responses()->resolve(*spQuery, *service, query, operationName, variables);
+	}
+
+	const auto ast = QueryCache::instance().parse(*service, query, operationName);
+
+	return response::toJSON(
+		service->resolve({ *ast, operationName, response::Value { variables } }).get());
+}
+
+GQLMAPI_EXPORT void ConfigureQueryCache(const QueryCacheOptions& options)
+{
+	QueryCache::instance().setCapacity(options.capacity);
+}
+
+GQLMAPI_EXPORT std::shared_ptr<const QueryCacheMetrics> GetQueryCacheMetrics() noexcept
+{
+	return QueryCache::instance().metrics();
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
@@ -3,8 +3,47 @@
 
 #include "Types.h"
 
+#include "Unicode.h"
+
 namespace graphql::mapi {
 
+namespace {
+
+// The status table only has rows for the MAPI subsystem, the address book, the spooler and each
+// transport provider.
+constexpr LONG c_statusRowCount = 100;
+
+// The MAPI subsystem row in the status table has the profile name as its display name.
+std::string ReadProfileName(IMAPISession* session)
+{
+	CComPtr<IMAPITable> sptable;
+	SizedSPropTagArray(2, statusProps) = { 2, { PR_RESOURCE_TYPE, PR_DISPLAY_NAME_W } };
+	rowset_ptr sprows;
+
+	CORt(session->GetStatusTable(0, &sptable));
+	CORt(sptable->SetColumns(reinterpret_cast<LPSPropTagArray>(&statusProps), TBL_BATCH));
+	CORt(sptable->QueryRows(c_statusRowCount, 0, &out_ptr { sprows }));
+
+	for (ULONG i = 0; i != sprows->cRows; i++)
+	{
+		const auto& row = sprows->aRow[i];
+
+		if (row.cValues == 2 && row.lpProps[0].ulPropTag == PR_RESOURCE_TYPE
+			&& row.lpProps[0].Value.l == MAPI_SUBSYSTEM
+			&& row.lpProps[1].ulPropTag == PR_DISPLAY_NAME_W)
+		{
+			return convert::utf8::to_utf8(row.lpProps[1].Value.lpszW);
+		}
+	}
+
+	return {};
+}
+
+std::mutex s_defaultSessionMutex;
+std::weak_ptr<Session> s_defaultSession;
+
+} // namespace
+
 Session::Session(bool useDefaultProfile)
 {
 	// Initialize and logon to the MAPI profile.
@@ -16,6 +55,35 @@ Session::Session(bool useDefaultProfile)
 		nullptr,
 		MAPI_EXTENDED | MAPI_UNICODE | MAPI_LOGON_UI | (useDefaultProfile ? MAPI_USE_DEFAULT : 0),
 		&m_session));
+
+	try
+	{
+		m_profile = ReadProfileName(m_session);
+	}
+	catch (const std::exception&)
+	{
+		// CORt and CFRt already reported the error, we just won't share the stores.
+	}
+}
+
+std::shared_ptr<Session> Session::logon(bool useDefaultProfile)
+{
+	if (!useDefaultProfile)
+	{
+		// The user picks the profile, so we can't tell if it's already logged on.
+		return std::make_shared<Session>(useDefaultProfile);
+	}
+
+	std::lock_guard lock { s_defaultSessionMutex };
+	auto session = s_defaultSession.lock();
+
+	if (!session)
+	{
+		session = std::make_shared<Session>(useDefaultProfile);
+		s_defaultSession = session;
+	}
+
+	return session;
 }
 
 Session::~Session()
@@ -32,4 +100,79 @@ const CComPtr<IMAPISession>& Session::session() const
 	return m_session;
 }
 
+const std::string& Session::profile() const
+{
+	return m_profile;
+}
+
+SharedStores& SharedStores::instance()
+{
+	static SharedStores s_instance;
+
+	return s_instance;
+}
+
+std::shared_ptr<Store> SharedStores::share(const std::string& profile,
+	std::shared_ptr<Store>&& store, const std::shared_ptr<const Query>& owner)
+{
+	std::lock_guard lock { m_mutex };
+
+	std::erase_if(m_stores, [](const auto& entry) noexcept {
+		return entry.second.store.expired();
+	});
+
+	auto& shared = m_stores[Key { profile, store->id() }];
+
+	if (auto existing = shared.store.lock(); existing && existing->sameColumns(*store))
+	{
+		return existing;
+	}
+
+	shared = Entry { store, owner };
+	return std::move(store);
+}
+
+bool SharedStores::owns(
+	const std::string& profile, const Store& store, const std::shared_ptr<const Query>& query)
+{
+	std::lock_guard lock { m_mutex };
+
+	const auto itr = m_stores.find(Key { profile, store.id() });
+
+	if (itr == m_stores.end() || itr->second.store.lock().get() != &store)
+	{
+		// Another store replaced it, so only the services with older snapshots still use it.
+		return true;
+	}
+
+	auto owner = itr->second.owner.lock();
+
+	if (!owner)
+	{
+		// The service which owned it was released, so this one takes over.
+		itr->second.owner = query;
+		return true;
+	}
+
+	return owner == query;
+}
+
+MAPIThreadScope::MAPIThreadScope() noexcept
+	: m_result { MAPIInitialize(nullptr) }
+{
+}
+
+MAPIThreadScope::~MAPIThreadScope()
+{
+	if (SUCCEEDED(m_result))
+	{
+		MAPIUninitialize();
+	}
+}
+
+MAPIThreadScope::operator bool() const noexcept
+{
+	return SUCCEEDED(m_result);
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Sha256.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace convert::sha256 {
+
+namespace {
+
+constexpr std::array<std::uint32_t, 64> c_roundConstants {
+	0x428a2f98,
+	0x71374491,
+	0xb5c0fbcf,
+	0xe9b5dba5,
+	0x3956c25b,
+	0x59f111f1,
+	0x923f82a4,
+	0xab1c5ed5,
+	0xd807aa98,
+	0x12835b01,
+	0x243185be,
+	0x550c7dc3,
+	0x72be5d74,
+	0x80deb1fe,
+	0x9bdc06a7,
+	0xc19bf174,
+	0xe49b69c1,
+	0xefbe4786,
+	0x0fc19dc6,
+	0x240ca1cc,
+	0x2de92c6f,
+	0x4a7484aa,
+	0x5cb0a9dc,
+	0x76f988da,
+	0x983e5152,
+	0xa831c66d,
+	0xb00327c8,
+	0xbf597fc7,
+	0xc6e00bf3,
+	0xd5a79147,
+	0x06ca6351,
+	0x14292967,
+	0x27b70a85,
+	0x2e1b2138,
+	0x4d2c6dfc,
+	0x53380d13,
+	0x650a7354,
+	0x766a0abb,
+	0x81c2c92e,
+	0x92722c85,
+	0xa2bfe8a1,
+	0xa81a664b,
+	0xc24b8b70,
+	0xc76c51a3,
+	0xd192e819,
+	0xd6990624,
+	0xf40e3585,
+	0x106aa070,
+	0x19a4c116,
+	0x1e376c08,
+	0x2748774c,
+	0x34b0bcb5,
+	0x391c0cb3,
+	0x4ed8aa4a,
+	0x5b9cca4f,
+	0x682e6ff3,
+	0x748f82ee,
+	0x78a5636f,
+	0x84c87814,
+	0x8cc70208,
+	0x90befffa,
+	0xa4506ceb,
+	0xbef9a3f7,
+	0xc67178f2,
+};
+
+constexpr std::uint32_t RotateRight(std::uint32_t value, int bits) noexcept
+{
+	return (value >> bits) | (value << (32 - bits));
+}
+
+void ProcessBlock(std::array<std::uint32_t, 8>& state, const std::uint8_t* block) noexcept
+{
+	std::array<std::uint32_t, 64> schedule {};
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		schedule[i] = (static_cast<std::uint32_t>(block[i * 4]) << 24)
+			| (static_cast<std::uint32_t>(block[i * 4 + 1]) << 16)
+			| (static_cast<std::uint32_t>(block[i * 4 + 2]) << 8)
+			| static_cast<std::uint32_t>(block[i * 4 + 3]);
+	}
+
+	for (size_t i = 16; i < schedule.size(); ++i)
+	{
+		const auto s0 = RotateRight(schedule[i - 15], 7) ^ RotateRight(schedule[i - 15], 18)
+			^ (schedule[i - 15] >> 3);
+		const auto s1 = RotateRight(schedule[i - 2], 17) ^ RotateRight(schedule[i - 2], 19)
+			^ (schedule[i - 2] >> 10);
+
+		schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+	}
+
+	auto [a, b, c, d, e, f, g, h] = state;
+
+	for (size_t i = 0; i < schedule.size(); ++i)
+	{
+		const auto s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+		const auto choose = (e & f) ^ (~e & g);
+		const auto temp1 = h + s1 + choose + c_roundConstants[i] + schedule[i];
+		const auto s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+		const auto majority = (a & b) ^ (a & c) ^ (b & c);
+		const auto temp2 = s0 + majority;
+
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+} // namespace
+
+std::string to_hex(std::string_view source)
+{
+	std::array<std::uint32_t, 8> state {
+		0x6a09e667,
+		0xbb67ae85,
+		0x3c6ef372,
+		0xa54ff53a,
+		0x510e527f,
+		0x9b05688c,
+		0x1f83d9ab,
+		0x5be0cd19,
+	};
+	const auto bytes = reinterpret_cast<const std::uint8_t*>(source.data());
+	const size_t fullBlocks = source.size() / 64;
+
+	for (size_t i = 0; i < fullBlocks; ++i)
+	{
+		ProcessBlock(state, bytes + i * 64);
+	}
+
+	// Pad the last block with a 1 bit, zeros, and the length in bits, which may spill over into
+	// another block.
+	std::array<std::uint8_t, 128> tail {};
+	const size_t remainder = source.size() - fullBlocks * 64;
+	const size_t tailSize = remainder < 56 ? 64 : 128;
+	const auto bitCount = static_cast<std::uint64_t>(source.size()) * 8;
+
+	std::copy(bytes + fullBlocks * 64, bytes + source.size(), tail.begin());
+	tail[remainder] = 0x80;
+
+	for (size_t i = 0; i < 8; ++i)
+	{
+		tail[tailSize - 1 - i] = static_cast<std::uint8_t>(bitCount >> (i * 8));
+	}
+
+	for (size_t offset = 0; offset < tailSize; offset += 64)
+	{
+		ProcessBlock(state, tail.data() + offset);
+	}
+
+	constexpr char c_hexDigits[] = "0123456789abcdef";
+	std::string result;
+
+	result.reserve(state.size() * 8);
+	for (const auto word : state)
+	{
+		for (int shift = 28; shift >= 0; shift -= 4)
+		{
+			result.push_back(c_hexDigits[(word >> shift) & 0xf]);
+		}
+	}
+
+	return result;
+}
+
+} // namespace convert::sha256
\ No newline at end of file
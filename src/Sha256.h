@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace convert::sha256 {
+
+// Lowercase hex SHA-256 digest, the same form clients use for persisted query IDs.
+std::string to_hex(std::string_view source);
+
+} // namespace convert::sha256
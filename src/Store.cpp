@@ -1,8 +1,6 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-#include <queue>
-
 #include "DateTime.h"
 #include "Guid.h"
 #include "Input.h"
@@ -12,8 +10,63 @@
 #include "FolderObject.h"
 #include "PropertyObject.h"
 
+#include <cctype>
+
 namespace graphql::mapi {
 
+namespace {
+
+// Hierarchy tables are read in batches this large until they run out of rows.
+constexpr LONG c_hierarchyBatchSize = 500;
+
+// Container classes are matched like a restriction with FL_PREFIX | FL_IGNORECASE.
+bool MatchesContainerClass(
+	const std::string& containerClass, const std::vector<std::string>& containerClasses) noexcept
+{
+	return std::any_of(containerClasses.cbegin(),
+		containerClasses.cend(),
+		[&containerClass](const std::string& prefix) noexcept {
+			return prefix.size() <= containerClass.size()
+				&& std::equal(prefix.cbegin(),
+					prefix.cend(),
+					containerClass.cbegin(),
+					[](char lhs, char rhs) noexcept {
+						return std::tolower(static_cast<unsigned char>(lhs))
+							== std::tolower(static_cast<unsigned char>(rhs));
+					});
+		});
+}
+
+// Workers take the deepest folder from their own queue, so they keep descending the same subtree,
+// and steal the shallowest folder from another queue, which is likely to have the most work left.
+std::optional<size_t> TakeFolder(std::vector<std::deque<size_t>>& queues, size_t index)
+{
+	if (!queues[index].empty())
+	{
+		const auto next = queues[index].back();
+
+		queues[index].pop_back();
+		return next;
+	}
+
+	for (size_t i = 1; i < queues.size(); ++i)
+	{
+		auto& queue = queues[(index + i) % queues.size()];
+
+		if (!queue.empty())
+		{
+			const auto next = queue.front();
+
+			queue.pop_front();
+			return next;
+		}
+	}
+
+	return std::nullopt;
+}
+
+} // namespace
+
 // Comparator for mapi_ptr<MAPINAMEID> for std::map
 bool CompareMAPINAMEID::operator()(
 	const mapi_ptr<MAPINAMEID>& lhs, const mapi_ptr<MAPINAMEID>& rhs) const noexcept
@@ -78,23 +131,26 @@ constexpr ULONG GetColumnPropType(Store::DefaultColumn column)
 static_assert(GetColumnPropType(Store::DefaultColumn::Id) == PT_BINARY, "type mismatch");
 static_assert(GetColumnPropType(Store::DefaultColumn::Name) == PT_UNICODE, "type mismatch");
 
-Store::Store(
-	const CComPtr<IMAPISession>& session, size_t columnCount, mapi_ptr<SPropValue>&& columns)
+Store::Store(const CComPtr<IMAPISession>& session, size_t columnCount,
+	mapi_ptr<SPropValue>&& columns, const HierarchyOptions& hierarchyOptions,
+	const TableCacheOptions& tableOptions, const std::shared_ptr<StoreExecutor>& executor)
 	: m_session { session }
 	, m_columnCount { columnCount }
 	, m_columns { std::move(columns) }
 	, m_id { GetIdColumn(DefaultColumn::Id) }
 	, m_name { GetStringColumn(DefaultColumn::Name) }
+	, m_hierarchyOptions { hierarchyOptions }
+	, m_tableOptions { tableOptions }
+	, m_executor { executor }
+	, m_rootFolders { tableOptions.windows }
 {
 }
 
 Store::~Store()
 {
 	// Release all of the MAPI objects we opened and free any MAPI memory allocations.
-	if (m_rootFolderSink)
-	{
-		m_rootFolderSink->Unadvise();
-	}
+	m_rootFolderListener.reset();
+	m_notifications.reset();
 }
 
 const CComPtr<IMsgStore>& Store::store()
@@ -103,6 +159,55 @@ const CComPtr<IMsgStore>& Store::store()
 	return m_store;
 }
 
+const std::shared_ptr<ObjectNotificationDispatcher>& Store::notifications()
+{
+	std::lock_guard lock { m_openMutex };
+
+	if (!m_notifications)
+	{
+		m_notifications = std::make_shared<ObjectNotificationDispatcher>(store());
+	}
+
+	return m_notifications;
+}
+
+bool Store::opened()
+{
+	std::lock_guard lock { m_openMutex };
+
+	return m_store != nullptr;
+}
+
+std::optional<size_t> Store::version()
+{
+	std::lock_guard lock { m_openMutex };
+
+	if (!m_notifications)
+	{
+		return std::nullopt;
+	}
+
+	return m_notifications->version();
+}
+
+bool Store::sameColumns(const Store& other) const
+{
+	return m_columnCount == other.m_columnCount
+		&& prop::GetChangedColumns(
+			other.m_columnCount, other.m_columns.get(), m_columnCount, m_columns.get())
+			   .empty();
+}
+
+const std::shared_ptr<StoreExecutor>& Store::executor() const
+{
+	return m_executor;
+}
+
+const TableCacheOptions& Store::tableOptions() const
+{
+	return m_tableOptions;
+}
+
 const response::IdType& Store::id() const
 {
 	return m_id;
@@ -113,24 +218,16 @@ const response::IdType& Store::rootId() const
 	return m_rootId;
 }
 
-const std::vector<std::shared_ptr<Folder>>& Store::rootFolders()
+std::shared_ptr<const std::vector<std::shared_ptr<Folder>>> Store::rootFolders()
 {
-	LoadRootFolders({});
-	return *m_rootFolders;
+	auto rootFolders = LoadRootFolders({});
+
+	return { rootFolders, &rootFolders->rows };
 }
 
 std::shared_ptr<Folder> Store::lookupRootFolder(const response::IdType& id)
 {
-	LoadRootFolders({});
-
-	auto itr = m_rootFolderIds->find(id);
-
-	if (itr == m_rootFolderIds->cend())
-	{
-		return nullptr;
-	}
-
-	return m_rootFolders->at(itr->second);
+	return LoadRootFolders({})->find(id);
 }
 
 const std::map<SpecialFolder, response::IdType>& Store::specialFolders()
@@ -156,12 +253,18 @@ std::shared_ptr<Folder> Store::lookupSpecialFolder(SpecialFolder id)
 std::vector<std::pair<ULONG, LPMAPINAMEID>> Store::lookupPropIdInputs(
 	std::vector<PropIdInput>&& namedProps)
 {
-	return prop::LookupPropIdInputs(store(), m_nameIdToPropIds, std::move(namedProps));
+	const auto& msgStore = store();
+	std::lock_guard lock { m_nameIdMutex };
+
+	return prop::LookupPropIdInputs(msgStore, m_nameIdToPropIds, std::move(namedProps));
 }
 
 std::vector<std::pair<ULONG, LPMAPINAMEID>> Store::lookupPropIds(const std::vector<ULONG>& propIds)
 {
-	return prop::LookupPropIds(store(), m_nameIdToPropIds, propIds);
+	const auto& msgStore = store();
+	std::lock_guard lock { m_nameIdMutex };
+
+	return prop::LookupPropIds(msgStore, m_nameIdToPropIds, propIds);
 }
 
 const SPropValue& Store::GetColumnProp(DefaultColumn column) const
@@ -262,7 +365,10 @@ std::vector<std::shared_ptr<object::Property>> Store::GetColumns(
 std::vector<std::shared_ptr<object::Property>> Store::GetProperties(
 	IMAPIProp* pObject, std::optional<std::vector<Column>>&& idsArg)
 {
-	return prop::GetProperties(store(), m_nameIdToPropIds, std::move(idsArg));
+	const auto& msgStore = store();
+	std::lock_guard lock { m_nameIdMutex };
+
+	return prop::GetProperties(msgStore, m_nameIdToPropIds, std::move(idsArg));
 }
 
 void Store::ConvertPropertyInputs(void* pAllocMore, LPSPropValue propBegin, LPSPropValue propEnd,
@@ -383,11 +489,9 @@ void Store::ConvertPropertyInputs(void* pAllocMore, LPSPropValue propBegin, LPSP
 
 std::shared_ptr<Folder> Store::OpenFolder(const response::IdType& folderId)
 {
-	auto itr = m_folderCache.find(folderId);
-
-	if (itr != m_folderCache.cend())
+	if (auto cached = m_folderCache.find(folderId))
 	{
-		return itr->second;
+		return cached;
 	}
 
 	ULONG objType = 0;
@@ -417,17 +521,15 @@ std::shared_ptr<Folder> Store::OpenFolder(const response::IdType& folderId)
 		static_cast<size_t>(cValues),
 		std::move(values));
 
-	CacheFolder(result);
-	return result;
+	// Another request may have opened the same folder in the meantime.
+	return CacheFolder(result);
 }
 
 std::shared_ptr<Item> Store::OpenItem(const response::IdType& itemId)
 {
-	auto itr = m_itemCache.find(itemId);
-
-	if (itr != m_itemCache.cend())
+	if (auto cached = m_itemCache.find(itemId))
 	{
-		return itr->second;
+		return cached;
 	}
 
 	ULONG objType = 0;
@@ -455,18 +557,45 @@ std::shared_ptr<Item> Store::OpenItem(const response::IdType& itemId)
 		static_cast<size_t>(cValues),
 		std::move(values));
 
-	CacheItem(result);
-	return result;
+	// Another request may have opened the same item in the meantime.
+	return CacheItem(result);
+}
+
+std::shared_ptr<Folder> Store::CacheFolder(const std::shared_ptr<Folder>& folder)
+{
+	return m_folderCache.insert(folder->id(), folder);
 }
 
-void Store::CacheFolder(const std::shared_ptr<Folder>& folder)
+std::shared_ptr<Item> Store::CacheItem(const std::shared_ptr<Item>& item)
 {
-	m_folderCache.insert(std::make_pair(folder->id(), folder));
+	return m_itemCache.insert(item->id(), item);
+}
+
+void Store::QueueFolder(const response::IdType& folderId)
+{
+	if (folderId.empty() || m_folderCache.find(folderId))
+	{
+		return;
+	}
+
+	std::lock_guard lock { m_queueMutex };
+
+	m_queuedFolderIds.insert(folderId);
 }
 
-void Store::CacheItem(const std::shared_ptr<Item>& item)
+void Store::OpenQueuedFolders()
 {
-	m_itemCache.insert(std::make_pair(item->id(), item));
+	std::vector<response::IdType> folderIds;
+
+	{
+		std::lock_guard lock { m_queueMutex };
+
+		folderIds.assign(m_queuedFolderIds.cbegin(), m_queuedFolderIds.cend());
+		m_queuedFolderIds.clear();
+	}
+
+	// Anything the restricted hierarchy table doesn't find is left for OpenFolder.
+	CacheFolders(folderIds);
 }
 
 void Store::ClearCaches()
@@ -477,6 +606,8 @@ void Store::ClearCaches()
 
 void Store::OpenStore()
 {
+	std::lock_guard lock { m_openMutex };
+
 	if (m_store)
 	{
 		return;
@@ -509,15 +640,6 @@ void Store::OpenStore()
 	m_storeProps.reset(storeIds);
 	CFRt(cValues == storeIdProps.cValues);
 
-	SizedSPropTagArray(5, folderIdProps) = { 5,
-		{
-			PR_IPM_APPOINTMENT_ENTRYID,
-			PR_IPM_CONTACT_ENTRYID,
-			PR_IPM_TASK_ENTRYID,
-			PR_IPM_ARCHIVE_ENTRYID,
-			PR_IPM_DRAFTS_ENTRYID,
-		} };
-
 	// The store must have an IPM Subtree.
 	LPSPropValue pRootId = storeIds + static_cast<size_t>(StoreProp::IPMSubtree);
 
@@ -527,69 +649,98 @@ void Store::OpenStore()
 	const auto rootIdEnd = rootIdBegin + static_cast<size_t>(pRootId->Value.bin.cb);
 
 	m_rootId = { rootIdBegin, rootIdEnd };
+}
+
+void Store::OpenIPMSubtree()
+{
+	std::lock_guard lock { m_openMutex };
+
+	if (m_ipmSubtree)
+	{
+		return;
+	}
+
+	OpenStore();
 
 	ULONG objType = 0;
 
-	CORt(m_store->OpenEntry(pRootId->Value.bin.cb,
-		reinterpret_cast<LPENTRYID>(pRootId->Value.bin.lpb),
+	CORt(m_store->OpenEntry(static_cast<ULONG>(m_rootId.size()),
+		reinterpret_cast<LPENTRYID>(m_rootId.data()),
 		&IID_IMAPIFolder,
 		MAPI_BEST_ACCESS | MAPI_DEFERRED_ERRORS,
 		&objType,
 		reinterpret_cast<LPUNKNOWN*>(&m_ipmSubtree)));
 	CFRt(m_ipmSubtree != nullptr) CFRt(objType == MAPI_FOLDER);
+}
 
-	LPSPropValue folderIds = nullptr;
-
-	CORt(m_ipmSubtree->GetProps(reinterpret_cast<LPSPropTagArray>(&folderIdProps),
-		MAPI_UNICODE,
-		&cValues,
-		&folderIds));
-	CFRt(folderIds != nullptr);
-	m_ipmSubtreeProps.reset(folderIds);
-	CFRt(cValues == folderIdProps.cValues);
-
+void Store::LoadInbox()
+{
 	ULONG cbInboxId = 0;
 	LPENTRYID peidInboxId = nullptr;
 
 	// Try to open the Inbox, if this store has one.
-	if (SUCCEEDED(
-			m_store->GetReceiveFolder(nullptr, MAPI_UNICODE, &cbInboxId, &peidInboxId, nullptr))
-		&& cbInboxId > 0 && peidInboxId != nullptr)
+	if (FAILED(m_store->GetReceiveFolder(nullptr, MAPI_UNICODE, &cbInboxId, &peidInboxId, nullptr)))
 	{
-		const auto idBegin = reinterpret_cast<std::uint8_t*>(peidInboxId);
-		const auto idEnd = idBegin + static_cast<size_t>(cbInboxId);
-		response::IdType id { idBegin, idEnd };
-		CComPtr<IMAPIFolder> inbox;
-
-		CORt(m_store->OpenEntry(cbInboxId,
-			peidInboxId,
-			&IID_IMAPIFolder,
-			MAPI_BEST_ACCESS | MAPI_DEFERRED_ERRORS,
-			&objType,
-			reinterpret_cast<LPUNKNOWN*>(&inbox)));
-		CFRt(inbox != nullptr) CFRt(objType == MAPI_FOLDER);
+		return;
+	}
 
-		m_cbInboxId = cbInboxId;
-		m_eidInboxId.reset(peidInboxId);
+	mapi_ptr<ENTRYID> eidInboxId { peidInboxId };
 
-		CORt(inbox->GetProps(reinterpret_cast<LPSPropTagArray>(&folderIdProps),
-			MAPI_UNICODE,
-			&cValues,
-			&folderIds));
-		CFRt(folderIds != nullptr);
-		m_inboxProps.reset(folderIds);
-		CFRt(cValues == folderIdProps.cValues);
+	if (cbInboxId == 0 || eidInboxId == nullptr)
+	{
+		return;
 	}
+
+	ULONG objType = 0;
+	CComPtr<IMAPIFolder> inbox;
+
+	CORt(m_store->OpenEntry(cbInboxId,
+		eidInboxId.get(),
+		&IID_IMAPIFolder,
+		MAPI_BEST_ACCESS | MAPI_DEFERRED_ERRORS,
+		&objType,
+		reinterpret_cast<LPUNKNOWN*>(&inbox)));
+	CFRt(inbox != nullptr) CFRt(objType == MAPI_FOLDER);
+
+	m_inboxProps = GetFolderIdProps(inbox);
+	m_cbInboxId = cbInboxId;
+	m_eidInboxId = std::move(eidInboxId);
+}
+
+mapi_ptr<SPropValue> Store::GetFolderIdProps(IMAPIFolder* folder)
+{
+	SizedSPropTagArray(5, folderIdProps) = { 5,
+		{
+			PR_IPM_APPOINTMENT_ENTRYID,
+			PR_IPM_CONTACT_ENTRYID,
+			PR_IPM_TASK_ENTRYID,
+			PR_IPM_ARCHIVE_ENTRYID,
+			PR_IPM_DRAFTS_ENTRYID,
+		} };
+
+	ULONG cValues = 0;
+	mapi_ptr<SPropValue> folderIds;
+
+	CORt(folder->GetProps(reinterpret_cast<LPSPropTagArray>(&folderIdProps),
+		MAPI_UNICODE,
+		&cValues,
+		&out_ptr { folderIds }));
+	CFRt(folderIds != nullptr);
+	CFRt(cValues == folderIdProps.cValues);
+
+	return folderIds;
 }
 
 void Store::LoadSpecialFolders()
 {
+	std::lock_guard lock { m_openMutex };
+
 	if (m_specialFolders)
 	{
 		return;
 	}
 
-	m_specialFolders = std::make_unique<std::map<SpecialFolder, response::IdType>>();
+	auto specialFolders = std::make_unique<std::map<SpecialFolder, response::IdType>>();
 
 	// Build the list of IDs from the properties we collected off of the store, the Inbox, and the
 	// IPM Subtree.
@@ -598,6 +749,28 @@ void Store::LoadSpecialFolders()
 	OpenStore();
 	FillInStoreProps(m_storeProps.get(), idMap);
 
+	// The Inbox doesn't depend on the IPM Subtree, so look for it on another thread while this one
+	// reads the IPM Subtree.
+	auto inboxLoaded = std::async(std::launch::async, [this]() {
+		const MAPIThreadScope scope;
+
+		if (!scope)
+		{
+			return false;
+		}
+
+		LoadInbox();
+		return true;
+	});
+
+	OpenIPMSubtree();
+	m_ipmSubtreeProps = GetFolderIdProps(m_ipmSubtree);
+
+	if (!inboxLoaded.get())
+	{
+		LoadInbox();
+	}
+
 	if (m_inboxProps)
 	{
 		idMap[SpecialFolder::INBOX] =
@@ -617,27 +790,26 @@ void Store::LoadSpecialFolders()
 		const auto idEnd = idBegin + static_cast<size_t>(cbEid);
 		response::IdType id { idBegin, idEnd };
 
-		m_specialFolders->insert(std::make_pair(specialFolder, std::move(id)));
+		specialFolders->insert(std::make_pair(specialFolder, std::move(id)));
 	}
+
+	m_specialFolders = std::move(specialFolders);
 }
 
-void Store::LoadRootFolders(service::Directives&& fieldDirectives)
+std::shared_ptr<const FolderSnapshot> Store::LoadRootFolders(
+	const service::Directives& fieldDirectives)
 {
-	if (m_rootFolderDirectives != fieldDirectives)
-	{
-		// Reset the subFolders and reload if the directives change
-		m_rootFolders.reset();
-		m_rootFolderDirectives = std::move(fieldDirectives);
-	}
+	// Keep a window for each set of table directives.
+	const TableDirectives directives { shared_from_this(), fieldDirectives };
 
-	if (m_rootFolders)
-	{
-		return;
-	}
-
-	m_rootFolderIds = std::make_unique<std::map<response::IdType, size_t>>();
-	m_rootFolders = std::make_unique<std::vector<std::shared_ptr<Folder>>>();
+	return m_rootFolders.load(directives.canonicalKey(),
+		[this, &directives](FolderSnapshot& snapshot) {
+			ReadRootFolders(directives, snapshot);
+		});
+}
 
+void Store::ReadRootFolders(const TableDirectives& directives, FolderSnapshot& snapshot)
+{
 	auto folderProps = GetFolderProperties();
 	constexpr auto c_folderSorts = Folder::GetFolderSorts();
 	mapi_ptr<SSortOrderSet> folderSorts;
@@ -650,10 +822,8 @@ void Store::LoadRootFolders(service::Directives&& fieldDirectives)
 	folderSorts->cExpanded = 0;
 	std::copy(c_folderSorts.begin(), c_folderSorts.end(), folderSorts->aSort);
 
-	OpenStore();
-	LoadSpecialFolders();
+	OpenIPMSubtree();
 
-	const TableDirectives directives { shared_from_this(), m_rootFolderDirectives };
 	CComPtr<IMAPITable> sptable;
 
 	CORt(m_ipmSubtree->GetHierarchyTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
@@ -661,7 +831,7 @@ void Store::LoadRootFolders(service::Directives&& fieldDirectives)
 	const rowset_ptr sprows =
 		directives.read(sptable, std::move(folderProps), std::move(folderSorts));
 
-	m_rootFolders->reserve(static_cast<size_t>(sprows->cRows));
+	snapshot.rows.reserve(static_cast<size_t>(sprows->cRows));
 	for (ULONG i = 0; i != sprows->cRows; i++)
 	{
 		auto& row = sprows->aRow[i];
@@ -674,31 +844,81 @@ void Store::LoadRootFolders(service::Directives&& fieldDirectives)
 			std::make_shared<Folder>(shared_from_this(), nullptr, columnCount, std::move(columns));
 
 		CacheFolder(folder);
-		m_rootFolderIds->insert(std::make_pair(folder->id(), m_rootFolders->size()));
-		m_rootFolders->push_back(std::move(folder));
+		snapshot.append(std::move(folder));
 	}
 
-	if (!m_rootFolderSink)
+	if (!m_rootFolderListener)
 	{
-		auto spThis = shared_from_this();
-		CComPtr<AdviseSinkProxy<IMAPITable>> sinkProxy;
-		ULONG_PTR connectionId = 0;
-
-		sinkProxy.Attach(new AdviseSinkProxy<IMAPITable>(
-			[wpStore = std::weak_ptr { spThis }](size_t, LPNOTIFICATION) {
+		m_rootFolderListener = notifications()->subscribe(m_rootId,
+			MAPI_FOLDER,
+			[wpStore = weak_from_this()](const NOTIFICATION&) {
 				auto spStore = wpStore.lock();
 
 				if (spStore)
 				{
 					spStore->m_rootFolders.reset();
 				}
-			}));
+			});
+	}
+}
 
-		CORt(sptable->Advise(fnevTableModified, sinkProxy, &connectionId));
-		sinkProxy->OnAdvise(sptable, connectionId);
+std::vector<std::shared_ptr<Folder>> Store::LookupRootFolders(
+	const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids)
+{
+	if (ids.empty())
+	{
+		return {};
+	}
 
-		m_rootFolderSink = sinkProxy;
+	OpenIPMSubtree();
+
+	const TableDirectives directives { shared_from_this(), fieldDirectives };
+	CComPtr<IMAPITable> sptable;
+
+	CORt(m_ipmSubtree->GetHierarchyTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
+
+	const rowset_ptr sprows = directives.lookup(sptable, GetFolderProperties(), ids);
+
+	if (!sprows)
+	{
+		// The provider can't restrict the table, so look for them in the current window.
+		const auto rootFolders = LoadRootFolders(fieldDirectives);
+		std::vector<std::shared_ptr<Folder>> result;
+
+		result.reserve(ids.size());
+		for (const auto& id : ids)
+		{
+			auto folder = rootFolders->find(id);
+
+			if (folder)
+			{
+				result.push_back(std::move(folder));
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<std::shared_ptr<Folder>> folders;
+
+	folders.reserve(static_cast<size_t>(sprows->cRows));
+	for (ULONG i = 0; i != sprows->cRows; i++)
+	{
+		auto& row = sprows->aRow[i];
+		const size_t columnCount = static_cast<size_t>(row.cValues);
+		mapi_ptr<SPropValue> columns { row.lpProps };
+
+		row.lpProps = nullptr;
+
+		auto folder =
+			std::make_shared<Folder>(shared_from_this(), nullptr, columnCount, std::move(columns));
+
+		// Return the columns this request read, even if another request cached the folder first.
+		CacheFolder(folder);
+		folders.push_back(std::move(folder));
 	}
+
+	return MatchEntryIds(ids, folders);
 }
 
 mapi_ptr<SPropTagArray> Store::GetFolderProperties() const
@@ -715,6 +935,581 @@ mapi_ptr<SPropTagArray> Store::GetFolderProperties() const
 	return folderProps;
 }
 
+std::optional<std::vector<std::shared_ptr<Folder>>> Store::ReadFolderHierarchy(
+	IMAPIFolder* pAncestor, std::optional<int> maxDepth,
+	const std::optional<std::vector<std::string>>& containerClasses)
+{
+	CComPtr<IMAPITable> sptable;
+
+	// Don't defer errors here, some providers reject CONVENIENT_DEPTH and we need to know before
+	// we start reading rows.
+	const HRESULT hrTable =
+		pAncestor->GetHierarchyTable(CONVENIENT_DEPTH | MAPI_UNICODE, &sptable);
+
+	if (hrTable == MAPI_E_NO_SUPPORT || hrTable == MAPI_E_TOO_COMPLEX
+		|| hrTable == MAPI_E_UNKNOWN_FLAGS)
+	{
+		return std::nullopt;
+	}
+
+	CORt(hrTable);
+
+	// Each clause is pushed into a single restriction on the table.
+	std::vector<SRestriction> clauses;
+	SPropValue depthProp {};
+
+	if (maxDepth)
+	{
+		// The first row is always one of the immediate children, so its PR_DEPTH tells us where
+		// the levels start counting.
+		SizedSPropTagArray(1, depthColumns) = { 1, { PR_DEPTH } };
+		rowset_ptr sprows;
+
+		CORt(sptable->SetColumns(reinterpret_cast<LPSPropTagArray>(&depthColumns), 0));
+		CORt(sptable->QueryRows(1, 0, &out_ptr { sprows }));
+
+		if (sprows->cRows == 0)
+		{
+			return std::vector<std::shared_ptr<Folder>> {};
+		}
+
+		CFRt(sprows->aRow[0].lpProps[0].ulPropTag == PR_DEPTH);
+		CORt(sptable->SeekRow(BOOKMARK_BEGINNING, 0, nullptr));
+
+		depthProp.ulPropTag = PR_DEPTH;
+		depthProp.Value.l = sprows->aRow[0].lpProps[0].Value.l + *maxDepth;
+
+		SRestriction clause {};
+
+		clause.rt = RES_PROPERTY;
+		clause.res.resProperty.relop = RELOP_LT;
+		clause.res.resProperty.ulPropTag = PR_DEPTH;
+		clause.res.resProperty.lpProp = &depthProp;
+		clauses.push_back(clause);
+	}
+
+	std::vector<std::wstring> classNames;
+	std::vector<SPropValue> classProps;
+	std::vector<SRestriction> classClauses;
+
+	if (containerClasses)
+	{
+		classNames.reserve(containerClasses->size());
+		for (const auto& containerClass : *containerClasses)
+		{
+			classNames.push_back(convert::utf8::to_utf16(containerClass));
+		}
+
+		classProps.resize(classNames.size());
+		classClauses.resize(classNames.size());
+		for (size_t i = 0; i < classNames.size(); ++i)
+		{
+			classProps[i].ulPropTag = PR_CONTAINER_CLASS_W;
+			classProps[i].Value.lpszW = const_cast<LPWSTR>(classNames[i].c_str());
+
+			classClauses[i].rt = RES_CONTENT;
+			classClauses[i].res.resContent.ulFuzzyLevel = FL_PREFIX | FL_IGNORECASE;
+			classClauses[i].res.resContent.ulPropTag = PR_CONTAINER_CLASS_W;
+			classClauses[i].res.resContent.lpProp = &classProps[i];
+		}
+
+		SRestriction clause {};
+
+		clause.rt = RES_OR;
+		clause.res.resOr.cRes = static_cast<ULONG>(classClauses.size());
+		clause.res.resOr.lpRes = classClauses.data();
+		clauses.push_back(clause);
+	}
+
+	if (!clauses.empty())
+	{
+		SRestriction restriction {};
+
+		restriction.rt = RES_AND;
+		restriction.res.resAnd.cRes = static_cast<ULONG>(clauses.size());
+		restriction.res.resAnd.lpRes = clauses.data();
+
+		const HRESULT hrRestrict = sptable->Restrict(&restriction, 0);
+
+		if (hrRestrict == MAPI_E_NO_SUPPORT || hrRestrict == MAPI_E_TOO_COMPLEX)
+		{
+			return std::nullopt;
+		}
+
+		CORt(hrRestrict);
+	}
+
+	auto folderProps = GetFolderProperties();
+
+	CORt(sptable->SetColumns(folderProps.get(), 0));
+
+	return ReadFolderRows(sptable);
+}
+
+std::vector<std::shared_ptr<Folder>> Store::WalkFolderHierarchy(
+	const std::shared_ptr<Folder>& ancestor, std::optional<int> maxDepth,
+	const std::optional<std::vector<std::string>>& containerClasses)
+{
+	// Open the store before the workers share it.
+	store();
+
+	struct Node
+	{
+		std::shared_ptr<Folder> folder;
+		int depth = 0;
+		std::vector<size_t> children;
+	};
+
+	const size_t threadCount = std::max<size_t>(m_hierarchyOptions.walkThreads, 1);
+	const auto folderProps = GetFolderProperties();
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+
+	// References to the nodes stay valid as the deque grows. The folders which are queued or being
+	// expanded are pending, and the walk is done when there are none left.
+	std::deque<Node> nodes;
+	std::vector<std::deque<size_t>> queues(threadCount);
+	size_t pending = 1;
+	std::exception_ptr error;
+
+	nodes.push_back({ ancestor, 0, {} });
+	queues.front().push_back(0);
+
+	const auto work = [&](size_t index) {
+		std::unique_lock lock { mutex };
+
+		for (;;)
+		{
+			std::optional<size_t> next;
+
+			workAvailable.wait(lock, [&]() {
+				return error || pending == 0 || (next = TakeFolder(queues, index)).has_value();
+			});
+
+			if (!next)
+			{
+				break;
+			}
+
+			auto& node = nodes[*next];
+			const auto folder = node.folder;
+			std::vector<std::shared_ptr<Folder>> subFolders;
+
+			// Expand the folder without holding the lock, each one is a round trip to the provider.
+			lock.unlock();
+
+			try
+			{
+				CComPtr<IMAPITable> sptable;
+
+				CORt(folder->folder()->GetHierarchyTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE,
+					&sptable));
+				CORt(sptable->SetColumns(folderProps.get(), 0));
+				subFolders = ReadFolderRows(sptable);
+			}
+			catch (...)
+			{
+				lock.lock();
+
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+
+				break;
+			}
+
+			lock.lock();
+
+			const int depth = node.depth + 1;
+
+			node.children.reserve(subFolders.size());
+			for (auto& subFolder : subFolders)
+			{
+				node.children.push_back(nodes.size());
+				nodes.push_back({ std::move(subFolder), depth, {} });
+			}
+
+			// Queue them in reverse, so this worker takes the first child next.
+			if (!maxDepth || depth < *maxDepth)
+			{
+				for (auto itr = node.children.crbegin(); itr != node.children.crend(); ++itr)
+				{
+					if (nodes[*itr].folder->hasSubfolders())
+					{
+						queues[index].push_back(*itr);
+						++pending;
+					}
+				}
+			}
+
+			--pending;
+			workAvailable.notify_all();
+		}
+
+		// Wake up the other workers if we're done or we stopped on an error.
+		workAvailable.notify_all();
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve(threadCount - 1);
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back([&work, i]() {
+			const MAPIThreadScope scope;
+
+			// If this thread can't use MAPI, leave its share of the folders to the others.
+			if (scope)
+			{
+				work(i);
+			}
+		});
+	}
+
+	work(0);
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	// Visit the nodes in the same pre-order as a CONVENIENT_DEPTH table, regardless of which
+	// worker expanded them first.
+	std::vector<std::shared_ptr<Folder>> results;
+	std::vector<size_t> stack { 0 };
+
+	while (!stack.empty())
+	{
+		const auto& node = nodes[stack.back()];
+
+		stack.pop_back();
+
+		if (node.depth > 0
+			&& (!containerClasses
+				|| MatchesContainerClass(node.folder->containerClass(), *containerClasses)))
+		{
+			results.push_back(node.folder);
+		}
+
+		stack.insert(stack.end(), node.children.crbegin(), node.children.crend());
+	}
+
+	return results;
+}
+
+std::vector<std::shared_ptr<Folder>> Store::ReadFolderRows(IMAPITable* pTable)
+{
+	std::vector<std::shared_ptr<Folder>> folders;
+
+	for (;;)
+	{
+		rowset_ptr sprows;
+
+		CORt(pTable->QueryRows(c_hierarchyBatchSize, 0, &out_ptr { sprows }));
+
+		if (sprows->cRows == 0)
+		{
+			break;
+		}
+
+		folders.reserve(folders.size() + static_cast<size_t>(sprows->cRows));
+		for (ULONG i = 0; i != sprows->cRows; i++)
+		{
+			auto& row = sprows->aRow[i];
+			const size_t columnCount = static_cast<size_t>(row.cValues);
+			mapi_ptr<SPropValue> columns { row.lpProps };
+
+			row.lpProps = nullptr;
+
+			auto folder = std::make_shared<Folder>(shared_from_this(),
+				nullptr,
+				columnCount,
+				std::move(columns));
+
+			folders.push_back(std::move(folder));
+		}
+	}
+
+	return folders;
+}
+
+Store::BatchProperties Store::ReadBatchProperties(const std::vector<response::IdType>& ids,
+	const std::optional<std::vector<Column>>& columns, IMAPIFolder* pContents,
+	const std::function<CComPtr<IMAPIProp>(const response::IdType&)>& open)
+{
+	BatchProperties result(ids.size());
+	const bool hasColumns = columns && !columns->empty();
+	prop::ResolvedColumns resolved;
+
+	if (hasColumns)
+	{
+		const auto& msgStore = store();
+		std::lock_guard lock { m_nameIdMutex };
+
+		resolved = prop::ResolveColumns(msgStore, m_nameIdToPropIds, *columns);
+	}
+
+	rowset_ptr sprows;
+
+	if (hasColumns && pContents && !ids.empty())
+	{
+		// Read the entry ID along with the columns, so we can tell which row is which.
+		const ULONG columnCount = resolved.propTags->cValues;
+		mapi_ptr<SPropTagArray> propTags;
+
+		CORt(::MAPIAllocateBuffer(CbNewSPropTagArray(columnCount + 1),
+			reinterpret_cast<void**>(&out_ptr { propTags })));
+		CFRt(propTags != nullptr);
+		propTags->cValues = columnCount + 1;
+		propTags->aulPropTag[0] = PR_ENTRYID;
+		std::copy(resolved.propTags->aulPropTag,
+			resolved.propTags->aulPropTag + columnCount,
+			propTags->aulPropTag + 1);
+
+		const TableDirectives directives { shared_from_this(), {} };
+		CComPtr<IMAPITable> sptable;
+
+		CORt(pContents->GetContentsTable(MAPI_DEFERRED_ERRORS | MAPI_UNICODE, &sptable));
+		sprows = directives.lookup(sptable, std::move(propTags), ids);
+	}
+
+	if (sprows)
+	{
+		const auto convertRow = [&resolved, &columns](const SRow& row) {
+			return prop::ConvertProperties(nullptr,
+				resolved.idMap,
+				&*columns,
+				row.lpProps + 1,
+				static_cast<size_t>(row.cValues - 1));
+		};
+
+		// Match the rows to the requested IDs by their bytes first. Comparing them with the store
+		// is a MAPI call for each pair, so only do that for the IDs and rows which are left over.
+		std::unordered_map<response::IdType, std::vector<size_t>, EntryIdHash> exactIds;
+		std::vector<std::pair<response::IdType, const SRow*>> unmatchedRows;
+
+		exactIds.reserve(ids.size());
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			exactIds[ids[i]].push_back(i);
+		}
+
+		for (ULONG i = 0; i != sprows->cRows; i++)
+		{
+			const auto& row = sprows->aRow[i];
+			const auto rowBegin = row.lpProps;
+			const auto rowEnd = rowBegin + row.cValues;
+
+			if (row.cValues == 0 || rowBegin->ulPropTag != PR_ENTRYID
+				|| std::any_of(rowBegin, rowEnd, [](const SPropValue& value) noexcept {
+					   return PROP_TYPE(value.ulPropTag) == PT_ERROR
+						   && value.Value.err == MAPI_E_NOT_ENOUGH_MEMORY;
+				   }))
+			{
+				// Open it instead, so the large values can be read as streams.
+				continue;
+			}
+
+			const auto idBegin = reinterpret_cast<std::uint8_t*>(rowBegin->Value.bin.lpb);
+			response::IdType rowId { idBegin, idBegin + rowBegin->Value.bin.cb };
+			const auto itr = exactIds.find(rowId);
+
+			if (itr == exactIds.end())
+			{
+				unmatchedRows.emplace_back(std::move(rowId), &row);
+				continue;
+			}
+
+			for (const auto index : itr->second)
+			{
+				result[index] = convertRow(row);
+			}
+		}
+
+		for (size_t i = 0; i < ids.size() && !unmatchedRows.empty(); ++i)
+		{
+			if (result[i])
+			{
+				continue;
+			}
+
+			const auto itr = std::find_if(unmatchedRows.cbegin(),
+				unmatchedRows.cend(),
+				[this, &id = ids[i]](const auto& entry) {
+					return CompareEntryIds(id, entry.first);
+				});
+
+			if (itr != unmatchedRows.cend())
+			{
+				result[i] = convertRow(*itr->second);
+			}
+		}
+	}
+
+	std::vector<size_t> remaining;
+
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		if (!result[i])
+		{
+			remaining.push_back(i);
+		}
+	}
+
+	// Without columns, keep the values until we've looked up the names for all of the objects.
+	std::vector<std::pair<ULONG, mapi_ptr<SPropValue>>> allValues(hasColumns ? 0 : ids.size());
+
+	// Open them one at a time, the store's MAPI calls all run in order on its strand. See the
+	// comment on ReadBatchProperties for why they aren't opened in parallel.
+	for (const auto index : remaining)
+	{
+		try
+		{
+			const auto object = open(ids[index]);
+
+			CFRt(object != nullptr);
+
+			if (hasColumns)
+			{
+				result[index] = prop::GetColumnProperties(object, resolved, *columns);
+			}
+			else
+			{
+				auto& [cValues, values] = allValues[index];
+
+				CORt(object->GetProps(nullptr, MAPI_UNICODE, &cValues, &out_ptr { values }));
+				CFRt(values != nullptr);
+			}
+		}
+		catch (const std::exception&)
+		{
+			// Leave it empty, the rest of the batch can still succeed.
+		}
+	}
+
+	if (hasColumns)
+	{
+		return result;
+	}
+
+	// Look up the names of all of the named properties in the batch together.
+	std::set<ULONG> propIds;
+
+	for (const auto& [cValues, values] : allValues)
+	{
+		for (ULONG i = 0; i < cValues; ++i)
+		{
+			propIds.insert(PROP_TAG(PT_UNSPECIFIED, PROP_ID(values.get()[i].ulPropTag)));
+		}
+	}
+
+	std::map<ULONG, Property::id_variant> idMap;
+
+	{
+		const auto& msgStore = store();
+		std::lock_guard lock { m_nameIdMutex };
+
+		idMap = prop::MapPropIds(msgStore,
+			m_nameIdToPropIds,
+			std::vector<ULONG> { propIds.cbegin(), propIds.cend() });
+	}
+
+	for (const auto index : remaining)
+	{
+		const auto& [cValues, values] = allValues[index];
+
+		if (values)
+		{
+			result[index] = prop::ConvertProperties(nullptr,
+				idMap,
+				nullptr,
+				values.get(),
+				static_cast<size_t>(cValues));
+		}
+	}
+
+	return result;
+}
+
+void Store::CacheFolders(const std::vector<response::IdType>& folderIds)
+{
+	std::vector<const response::IdType*> missing;
+
+	for (const auto& folderId : folderIds)
+	{
+		if (!folderId.empty() && !m_folderCache.find(folderId))
+		{
+			missing.push_back(&folderId);
+		}
+	}
+
+	// It's not worth reading a table to open a single folder.
+	if (missing.size() < 2)
+	{
+		return;
+	}
+
+	CComPtr<IMAPITable> sptable;
+	const HRESULT hrTable = OpenFolder(rootId())->folder()->GetHierarchyTable(
+		CONVENIENT_DEPTH | MAPI_UNICODE,
+		&sptable);
+
+	if (hrTable == MAPI_E_NO_SUPPORT || hrTable == MAPI_E_TOO_COMPLEX
+		|| hrTable == MAPI_E_UNKNOWN_FLAGS)
+	{
+		return;
+	}
+
+	CORt(hrTable);
+
+	EntryIdRestriction restriction { missing };
+	const HRESULT hrRestrict = sptable->Restrict(restriction.get(), 0);
+
+	if (hrRestrict == MAPI_E_NO_SUPPORT || hrRestrict == MAPI_E_TOO_COMPLEX)
+	{
+		return;
+	}
+
+	CORt(hrRestrict);
+
+	auto folderProps = GetFolderProperties();
+
+	CORt(sptable->SetColumns(folderProps.get(), 0));
+
+	for (const auto& folder : ReadFolderRows(sptable))
+	{
+		CacheFolder(folder);
+
+		// Cache it under the ID we asked for too.
+		for (const auto folderId : missing)
+		{
+			if (*folderId != folder->id() && CompareEntryIds(*folderId, folder->id()))
+			{
+				m_folderCache.insert(*folderId, folder);
+			}
+		}
+	}
+}
+
+bool Store::CompareEntryIds(const response::IdType& lhs, const response::IdType& rhs)
+{
+	ULONG result = 0;
+
+	return SUCCEEDED(store()->CompareEntryIDs(static_cast<ULONG>(lhs.size()),
+			   reinterpret_cast<LPENTRYID>(const_cast<response::IdType&>(lhs).data()),
+			   static_cast<ULONG>(rhs.size()),
+			   reinterpret_cast<LPENTRYID>(const_cast<response::IdType&>(rhs).data()),
+			   0,
+			   &result))
+		&& result != 0;
+}
+
 mapi_ptr<SPropTagArray> Store::GetItemProperties() const
 {
 	constexpr auto c_itemProps = Item::GetItemColumns();
@@ -747,82 +1542,127 @@ std::vector<std::shared_ptr<object::Property>> Store::getColumns()
 	return { GetColumns(m_columnCount - offset, m_columns.get() + offset) };
 }
 
-std::optional<std::vector<std::shared_ptr<object::Folder>>> Store::getFolderHierarchy(
-    std::optional<response::IdType> parentFolderIdArg, response::BooleanType&& onlyChildrenArg)
+service::AwaitableObject<std::optional<std::vector<std::shared_ptr<object::Folder>>>>
+Store::getFolderHierarchy(std::optional<response::IdType> parentFolderIdArg,
+	response::BooleanType onlyChildrenArg, std::optional<int> maxDepthArg,
+	std::optional<std::vector<std::string>> containerClassesArg)
 {
-    std::shared_ptr<Folder> ancestor;
-    if (parentFolderIdArg)
-    {
-        ancestor = OpenFolder(convert::input::from_input(std::move(parentFolderIdArg.value())));
-    }
-    else
-    {
-        ancestor = OpenFolder(rootId());
-    }
-    CFRt(ancestor != nullptr);
+	const auto spThis = shared_from_this();
+
+	co_await m_executor->schedule(this);
+
+	std::shared_ptr<Folder> ancestor;
 
-    std::vector<std::shared_ptr<object::Folder>> results;
+	if (parentFolderIdArg)
+	{
+		ancestor = OpenFolder(convert::input::from_input(std::move(*parentFolderIdArg)));
+	}
+	else
+	{
+		ancestor = OpenFolder(rootId());
+	}
+
+	CFRt(ancestor != nullptr);
 
-    std::queue<std::shared_ptr<Folder>> foldersToProcess;
-    foldersToProcess.emplace(std::move(ancestor));
+	// The immediate children are 1 level below the ancestor.
+	auto maxDepth = std::move(maxDepthArg);
 
-	while (!foldersToProcess.empty())
-    {
-        std::vector<std::shared_ptr<Folder>> nextSubfolders = foldersToProcess.front()->subFolders();
-        foldersToProcess.pop();
+	if (onlyChildrenArg)
+	{
+		maxDepth = std::min(maxDepth.value_or(1), 1);
+	}
 
-        for (auto& subfolder : nextSubfolders)
-        {
-            results.emplace_back(std::make_shared<object::Folder>(subfolder));
+	std::vector<std::shared_ptr<object::Folder>> results;
+
+	if (maxDepth && *maxDepth < 1)
+	{
+		co_return results;
+	}
+
+	auto folders = ReadFolderHierarchy(ancestor->folder(), maxDepth, containerClassesArg);
+
+	if (!folders)
+	{
+		folders = WalkFolderHierarchy(ancestor, maxDepth, containerClassesArg);
+	}
 
-            if (subfolder->hasSubfolders())
-                foldersToProcess.emplace(std::move(subfolder));
-        }
-    }
+	results.reserve(folders->size());
+	for (const auto& folder : *folders)
+	{
+		CacheFolder(folder);
+		results.push_back(std::make_shared<object::Folder>(folder));
+	}
 
-    return results;
+	co_return results;
 }
 
-std::vector<std::shared_ptr<object::Folder>> Store::getRootFolders(
-	service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> Store::getRootFolders(
+	service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg)
 {
-	std::vector<std::shared_ptr<object::Folder>> result {};
+	const auto spThis = shared_from_this();
+	const auto fieldDirectives = std::move(params.fieldDirectives);
 
-	LoadRootFolders(std::move(params.fieldDirectives));
+	co_await m_executor->schedule(this);
+
+	std::vector<std::shared_ptr<object::Folder>> result {};
 
 	if (idsArg)
 	{
 		// Lookup the root folders with the specified IDs
-		result.resize(idsArg->size());
-		std::transform(idsArg->cbegin(),
-			idsArg->cend(),
+		const auto rootFolders = LookupRootFolders(fieldDirectives, *idsArg);
+
+		result.resize(rootFolders.size());
+		std::transform(rootFolders.cbegin(),
+			rootFolders.cend(),
 			result.begin(),
-			[this](const response::IdType& id) noexcept {
-				return std::make_shared<object::Folder>(lookupRootFolder(id));
+			[](const std::shared_ptr<Folder>& folder) noexcept {
+				return std::make_shared<object::Folder>(folder);
 			});
 	}
 	else
 	{
+		const auto rootFolders = LoadRootFolders(fieldDirectives);
+
 		// Just clone the entire vector of stores.
-		result.resize(m_rootFolders->size());
-		std::transform(m_rootFolders->cbegin(),
-			m_rootFolders->cend(),
+		result.resize(rootFolders->rows.size());
+		std::transform(rootFolders->rows.cbegin(),
+			rootFolders->rows.cend(),
 			result.begin(),
 			[this](const std::shared_ptr<Folder>& folder) noexcept {
 				return std::make_shared<object::Folder>(folder);
 			});
 	}
 
-	return result;
+	co_return result;
 }
 
-std::vector<std::shared_ptr<object::Folder>> Store::getSpecialFolders(
-	std::vector<SpecialFolder>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> Store::getSpecialFolders(
+	std::vector<SpecialFolder> idsArg)
 {
+	const auto spThis = shared_from_this();
+
+	co_await m_executor->schedule(this);
+
 	std::vector<std::shared_ptr<object::Folder>> result {};
 
 	LoadSpecialFolders();
 
+	// Open all of the special folders we don't have yet together, instead of one at a time.
+	std::vector<response::IdType> folderIds;
+
+	folderIds.reserve(idsArg.size());
+	for (const auto id : idsArg)
+	{
+		auto itr = m_specialFolders->find(id);
+
+		if (itr != m_specialFolders->cend())
+		{
+			folderIds.push_back(itr->second);
+		}
+	}
+
+	CacheFolders(folderIds);
+
 	// Lookup the special folders with the specified IDs
 	result.resize(idsArg.size());
 	std::transform(idsArg.cbegin(),
@@ -832,25 +1672,97 @@ std::vector<std::shared_ptr<object::Folder>> Store::getSpecialFolders(
 			return std::make_shared<object::Folder>(lookupSpecialFolder(id));
 		});
 
-	return result;
+	co_return result;
 }
 
-std::vector<std::shared_ptr<object::Property>> Store::getFolderProperties(
-	response::IdType&& folderIdArg, std::optional<std::vector<Column>>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Property>>> Store::getFolderProperties(
+	response::IdType folderIdArg, std::optional<std::vector<Column>> idsArg)
 {
-	auto folder = OpenFolder(convert::input::from_input(std::move(folderIdArg)));
+	const auto spThis = shared_from_this();
+	const auto folderId = convert::input::from_input(std::move(folderIdArg));
+
+	QueueFolder(folderId);
+	co_await m_executor->schedule(this);
+	OpenQueuedFolders();
+
+	auto folder = OpenFolder(folderId);
 
 	CFRt(folder != nullptr);
-	return { GetProperties(static_cast<IMAPIFolder*>(folder->folder()), std::move(idsArg)) };
+	co_return GetProperties(static_cast<IMAPIFolder*>(folder->folder()), std::move(idsArg));
 }
 
-std::vector<std::shared_ptr<object::Property>> Store::getItemProperties(
-	response::IdType&& itemIdArg, std::optional<std::vector<Column>>&& idsArg)
+service::AwaitableObject<std::vector<std::shared_ptr<object::Property>>> Store::getItemProperties(
+	response::IdType itemIdArg, std::optional<std::vector<Column>> idsArg)
 {
+	const auto spThis = shared_from_this();
+
+	co_await m_executor->schedule(this);
+
 	auto item = OpenItem(convert::input::from_input(std::move(itemIdArg)));
 
 	CFRt(item != nullptr);
-	return { GetProperties(static_cast<IMessage*>(item->message()), std::move(idsArg)) };
+	co_return GetProperties(static_cast<IMessage*>(item->message()), std::move(idsArg));
+}
+
+service::AwaitableObject<Store::BatchProperties> Store::getFoldersProperties(
+	std::vector<response::IdType> folderIdsArg, std::optional<std::vector<Column>> idsArg)
+{
+	const auto spThis = shared_from_this();
+	std::vector<response::IdType> folderIds(folderIdsArg.size());
+
+	std::transform(folderIdsArg.begin(),
+		folderIdsArg.end(),
+		folderIds.begin(),
+		[](response::IdType& id) {
+			return convert::input::from_input(std::move(id));
+		});
+
+	co_await m_executor->schedule(this);
+
+	co_return ReadBatchProperties(folderIds,
+		idsArg,
+		nullptr,
+		[this](const response::IdType& folderId) {
+			auto folder = OpenFolder(folderId);
+
+			CFRt(folder != nullptr);
+			return CComPtr<IMAPIProp> { static_cast<IMAPIFolder*>(folder->folder()) };
+		});
+}
+
+service::AwaitableObject<Store::BatchProperties> Store::getItemsProperties(
+	std::optional<response::IdType> folderIdArg, std::vector<response::IdType> itemIdsArg,
+	std::optional<std::vector<Column>> idsArg)
+{
+	const auto spThis = shared_from_this();
+	std::vector<response::IdType> itemIds(itemIdsArg.size());
+
+	std::transform(itemIdsArg.begin(),
+		itemIdsArg.end(),
+		itemIds.begin(),
+		[](response::IdType& id) {
+			return convert::input::from_input(std::move(id));
+		});
+
+	co_await m_executor->schedule(this);
+
+	std::shared_ptr<Folder> folder;
+
+	if (folderIdArg)
+	{
+		folder = OpenFolder(convert::input::from_input(std::move(*folderIdArg)));
+		CFRt(folder != nullptr);
+	}
+
+	co_return ReadBatchProperties(itemIds,
+		idsArg,
+		folder ? static_cast<IMAPIFolder*>(folder->folder()) : nullptr,
+		[this](const response::IdType& itemId) {
+			auto item = OpenItem(itemId);
+
+			CFRt(item != nullptr);
+			return CComPtr<IMAPIProp> { static_cast<IMessage*>(item->message()) };
+		});
 }
 
 void Store::FillInStoreProps(LPSPropValue storeIds, std::map<SpecialFolder, SBinary>& idMap)
@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+namespace {
+
+// The store whose work is running on this thread, so nested work for it runs inline instead of
+// waiting behind itself.
+thread_local StoreExecutor::Key t_currentKey = nullptr;
+
+} // namespace
+
+StoreExecutor::StoreExecutor(const ExecutorOptions& options)
+	: m_state { std::make_shared<State>() }
+{
+	m_threads.reserve(options.storeThreads);
+	for (size_t i = 0; i < options.storeThreads; ++i)
+	{
+		m_threads.emplace_back([state = m_state]() {
+			// If this thread can't use MAPI, the work reports the errors through its futures.
+			const MAPIThreadScope scope;
+
+			Run(state);
+		});
+	}
+}
+
+StoreExecutor::~StoreExecutor()
+{
+	std::deque<std::pair<Key, Work>> pending;
+
+	{
+		std::lock_guard lock { m_state->mutex };
+
+		m_state->stopped = true;
+		pending = std::move(m_state->queue);
+		m_state->queue.clear();
+	}
+
+	m_state->workAvailable.notify_all();
+
+	for (auto& thread : m_threads)
+	{
+		if (thread.get_id() == std::this_thread::get_id())
+		{
+			// Some of our own work released the last reference, the thread will exit as soon as it
+			// returns.
+			thread.detach();
+		}
+		else
+		{
+			thread.join();
+		}
+	}
+}
+
+StoreExecutor::Awaitable::Awaitable(StoreExecutor& executor, Key key) noexcept
+	: m_executor { executor }
+	, m_key { key }
+{
+}
+
+bool StoreExecutor::Awaitable::await_ready() const noexcept
+{
+	return m_executor.m_threads.empty() || t_currentKey == m_key;
+}
+
+void StoreExecutor::Awaitable::await_suspend(std::coroutine_handle<> handle)
+{
+	m_executor.post(m_key, [handle]() {
+		handle.resume();
+	});
+}
+
+void StoreExecutor::Awaitable::await_resume() const noexcept
+{
+}
+
+StoreExecutor::Awaitable StoreExecutor::schedule(Key key) noexcept
+{
+	return { *this, key };
+}
+
+void StoreExecutor::post(Key key, Work&& work)
+{
+	{
+		std::lock_guard lock { m_state->mutex };
+
+		if (!m_state->stopped)
+		{
+			m_state->queue.emplace_back(key, std::move(work));
+			m_state->workAvailable.notify_all();
+			return;
+		}
+	}
+
+	// A suspended coroutine must resume somewhere, or it never completes its result.
+	work();
+}
+
+void StoreExecutor::Run(const std::shared_ptr<State>& state)
+{
+	std::unique_lock lock { state->mutex };
+
+	while (!state->stopped)
+	{
+		// Take the oldest work for a store which isn't already running on another thread.
+		const auto itr = std::find_if(state->queue.begin(),
+			state->queue.end(),
+			[&busy = state->busy](const auto& entry) noexcept {
+				return busy.find(entry.first) == busy.end();
+			});
+
+		if (itr == state->queue.end())
+		{
+			state->workAvailable.wait(lock);
+			continue;
+		}
+
+		const auto key = itr->first;
+
+		{
+			// Release the work before re-acquiring the lock, it might hold the last reference to
+			// the StoreExecutor.
+			auto work = std::move(itr->second);
+
+			state->queue.erase(itr);
+			state->busy.insert(key);
+			lock.unlock();
+
+			// The coroutine delivers any exceptions through its promise.
+			t_currentKey = key;
+			work();
+			t_currentKey = nullptr;
+		}
+
+		lock.lock();
+		state->busy.erase(key);
+
+		// There may be more work waiting for the same store.
+		state->workAvailable.notify_all();
+	}
+}
+
+} // namespace graphql::mapi
\ No newline at end of file
@@ -7,8 +7,9 @@
 namespace graphql::mapi {
 
 SubFoldersSubscription::SubFoldersSubscription(
-	std::vector<std::shared_ptr<object::FolderChange>>&& subFolders)
+	std::vector<std::shared_ptr<object::FolderChange>>&& subFolders, std::optional<int> resumedFrom)
 	: m_subFolders { std::move(subFolders) }
+	, m_resumedFrom { resumedFrom }
 {
 }
 
@@ -19,8 +20,13 @@ std::vector<std::shared_ptr<object::ItemChange>> SubFoldersSubscription::getItem
 }
 
 std::vector<std::shared_ptr<object::FolderChange>> SubFoldersSubscription::getSubFolders(
-	ObjectId&& parentFolderIdArg) const
+	service::FieldParams&& params, ObjectId&& parentFolderIdArg) const
 {
+	if (m_resumedFrom && Subscription::GetResumeDirective(params.fieldDirectives) != m_resumedFrom)
+	{
+		return {};
+	}
+
 	return m_subFolders;
 }
 
@@ -30,4 +36,10 @@ std::vector<std::shared_ptr<object::FolderChange>> SubFoldersSubscription::getRo
 	return {};
 }
 
+std::vector<std::shared_ptr<object::FolderCounts>> SubFoldersSubscription::getFolderCounts(
+	std::vector<ObjectId>&& folderIdsArg) const
+{
+	return {};
+}
+
 } // namespace graphql::mapi
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "FolderAddedObject.h"
 #include "FolderChangeObject.h"
+#include "FolderCountsObject.h"
 #include "FolderRemovedObject.h"
 #include "FolderUpdatedObject.h"
 #include "FoldersReloadedObject.h"
@@ -17,21 +18,66 @@
 #include "ItemsReloadedObject.h"
 #include "SubscriptionObject.h"
 
+#include <limits>
+
 using namespace std::literals;
 
 namespace graphql::mapi {
 
-Subscription::Subscription(const std::shared_ptr<Query>& query)
+namespace {
+
+int GetResumeSequence(const response::Value& directive)
+{
+	return service::ModifiedArgument<int>::require("sequence"sv, directive);
+}
+
+// Sequences are delivered as Int!, so they count from 1 up to the largest Int and then wrap back
+// around to 1, and 0 is only the starting point before the first change.
+constexpr int c_maxSequence = std::numeric_limits<int>::max();
+
+int NextSequence(std::atomic<int>& counter) noexcept
+{
+	int current = counter.load();
+	int next = 0;
+
+	do
+	{
+		next = current == c_maxSequence ? 1 : current + 1;
+	} while (!counter.compare_exchange_weak(current, next));
+
+	return next;
+}
+
+// Count how many sequences came after this one, up to the current one, so a sequence from before
+// the counter wrapped still compares as older. That only works until it wraps all the way around.
+int SequenceDistance(int current, int sequence) noexcept
+{
+	return current >= sequence ? current - sequence : current + (c_maxSequence - sequence);
+}
+
+} // namespace
+
+Subscription::Subscription(const std::shared_ptr<Query>& query, const SubscriptionOptions& options)
 	: m_query { query }
+	, m_options { options }
+	, m_timerQueue { options.coalesceWindow.count() > 0 ? std::make_unique<TimerQueue>()
+			: std::unique_ptr<TimerQueue> {} }
+	, m_notificationQueue { options.dispatchThreads > 0
+			? std::make_unique<NotificationQueue>(options)
+			: std::unique_ptr<NotificationQueue> {} }
 {
 }
 
 Subscription::~Subscription()
 {
 	// Release all of the MAPI objects we opened and free any MAPI memory allocations.
+	m_idleItemSinks.clear();
+	m_idleSubFolderSinks.clear();
+	m_idleRootFolderSinks.clear();
 	m_itemSinks.clear();
 	m_subFolderSinks.clear();
 	m_rootFolderSinks.clear();
+	m_countSinks.clear();
 }
 
 void Subscription::setService(const std::shared_ptr<Operations>& service) noexcept
@@ -42,35 +88,49 @@ void Subscription::setService(const std::shared_ptr<Operations>& service) noexce
 std::vector<std::shared_ptr<object::ItemChange>> Subscription::getItems(
 	service::FieldParams&& params, ObjectId&& folderIdArg)
 {
-	Registration<Item> registration { { convert::input::from_input(std::move(folderIdArg)),
-		std::move(params.fieldDirectives) } };
-	const auto [itr, itrEnd] = m_itemSinks.equal_range(registration);
+	const auto resume = TakeResumeDirective(params.fieldDirectives);
+	RegistrationKey key { convert::input::from_input(std::move(folderIdArg)),
+		std::move(params.fieldDirectives) };
 
 	switch (params.resolverContext)
 	{
 		case service::ResolverContext::NotifySubscribe:
 		{
-			if (itr == itrEnd)
+			auto itr = m_itemSinks.find(key);
+
+			if (itr == m_itemSinks.end())
 			{
+				Registration<Item> registration;
+
 				RegisterAdviseSinkProxy<Item, ObjectId, ItemsSubscription>(params.launch,
 					"items"s,
 					"folderId"sv,
-					registration.key.objectId,
+					key.objectId,
+					key,
 					registration);
+				itr = m_itemSinks.emplace(std::move(key), std::move(registration)).first;
 			}
-			else
+			else if (itr->second.subscribers == 0)
 			{
-				registration.sink = itr->sink;
+				// This registration was retained for @resume after the last subscriber left.
+				RegisterAdviseSinkProxy<Item, ObjectId, ItemsSubscription>(params.launch,
+					"items"s,
+					"folderId"sv,
+					itr->first.objectId,
+					itr->first,
+					itr->second);
 			}
 
-			m_itemSinks.insert(itrEnd, std::move(registration));
+			AddSubscriber(m_idleItemSinks, itr->second, resume);
 			break;
 		}
 
 		case service::ResolverContext::NotifyUnsubscribe:
 		{
-			CFRt(itr != itrEnd);
-			m_itemSinks.erase(itr);
+			const auto itr = m_itemSinks.find(key);
+
+			CFRt(itr != m_itemSinks.end());
+			RemoveSubscriber(m_itemSinks, m_idleItemSinks, itr, resume);
 			break;
 		}
 
@@ -87,35 +147,49 @@ std::vector<std::shared_ptr<object::ItemChange>> Subscription::getItems(
 std::vector<std::shared_ptr<object::FolderChange>> Subscription::getSubFolders(
 	service::FieldParams&& params, ObjectId&& parentFolderIdArg)
 {
-	Registration<Folder> registration { { convert::input::from_input(std::move(parentFolderIdArg)),
-		std::move(params.fieldDirectives) } };
-	const auto [itr, itrEnd] = m_subFolderSinks.equal_range(registration);
+	const auto resume = TakeResumeDirective(params.fieldDirectives);
+	RegistrationKey key { convert::input::from_input(std::move(parentFolderIdArg)),
+		std::move(params.fieldDirectives) };
 
 	switch (params.resolverContext)
 	{
 		case service::ResolverContext::NotifySubscribe:
 		{
-			if (itr == itrEnd)
+			auto itr = m_subFolderSinks.find(key);
+
+			if (itr == m_subFolderSinks.end())
 			{
+				Registration<Folder> registration;
+
 				RegisterAdviseSinkProxy<Folder, ObjectId, SubFoldersSubscription>(params.launch,
 					"subFolders"s,
 					"parentFolderId"sv,
-					registration.key.objectId,
+					key.objectId,
+					key,
 					registration);
+				itr = m_subFolderSinks.emplace(std::move(key), std::move(registration)).first;
 			}
-			else
+			else if (itr->second.subscribers == 0)
 			{
-				registration.sink = itr->sink;
+				// This registration was retained for @resume after the last subscriber left.
+				RegisterAdviseSinkProxy<Folder, ObjectId, SubFoldersSubscription>(params.launch,
+					"subFolders"s,
+					"parentFolderId"sv,
+					itr->first.objectId,
+					itr->first,
+					itr->second);
 			}
 
-			m_subFolderSinks.insert(itrEnd, std::move(registration));
+			AddSubscriber(m_idleSubFolderSinks, itr->second, resume);
 			break;
 		}
 
 		case service::ResolverContext::NotifyUnsubscribe:
 		{
-			CFRt(itr != itrEnd);
-			m_subFolderSinks.erase(itr);
+			const auto itr = m_subFolderSinks.find(key);
+
+			CFRt(itr != m_subFolderSinks.end());
+			RemoveSubscriber(m_subFolderSinks, m_idleSubFolderSinks, itr, resume);
 			break;
 		}
 
@@ -132,119 +206,1176 @@ std::vector<std::shared_ptr<object::FolderChange>> Subscription::getSubFolders(
 std::vector<std::shared_ptr<object::FolderChange>> Subscription::getRootFolders(
 	service::FieldParams&& params, response::IdType&& storeIdArg)
 {
-	Registration<Folder> registration {
-		{ ObjectId { convert::input::from_input(std::move(storeIdArg)), {} },
-			std::move(params.fieldDirectives) }
-	};
-	const auto [itr, itrEnd] = m_rootFolderSinks.equal_range(registration);
+	const auto resume = TakeResumeDirective(params.fieldDirectives);
+	RegistrationKey key { ObjectId { convert::input::from_input(std::move(storeIdArg)), {} },
+		std::move(params.fieldDirectives) };
+
+	switch (params.resolverContext)
+	{
+		case service::ResolverContext::NotifySubscribe:
+		{
+			auto itr = m_rootFolderSinks.find(key);
+
+			if (itr == m_rootFolderSinks.end())
+			{
+				Registration<Folder> registration;
+
+				RegisterAdviseSinkProxy<Folder, response::IdType, RootFoldersSubscription>(
+					params.launch,
+					"rootFolders"s,
+					"storeId"sv,
+					key.objectId.storeId,
+					key,
+					registration);
+				itr = m_rootFolderSinks.emplace(std::move(key), std::move(registration)).first;
+			}
+			else if (itr->second.subscribers == 0)
+			{
+				// This registration was retained for @resume after the last subscriber left.
+				RegisterAdviseSinkProxy<Folder, response::IdType, RootFoldersSubscription>(
+					params.launch,
+					"rootFolders"s,
+					"storeId"sv,
+					itr->first.objectId.storeId,
+					itr->first,
+					itr->second);
+			}
+
+			AddSubscriber(m_idleRootFolderSinks, itr->second, resume);
+			break;
+		}
+
+		case service::ResolverContext::NotifyUnsubscribe:
+		{
+			const auto itr = m_rootFolderSinks.find(key);
+
+			CFRt(itr != m_rootFolderSinks.end());
+			RemoveSubscriber(m_rootFolderSinks, m_idleRootFolderSinks, itr, resume);
+			break;
+		}
+
+		default:
+		{
+			constexpr bool Unexpected_ResolverContext = false;
+			CFRt(Unexpected_ResolverContext);
+		}
+	}
+
+	return {};
+}
 
+std::vector<std::shared_ptr<object::FolderCounts>> Subscription::getFolderCounts(
+	service::FieldParams&& params, std::vector<ObjectId>&& folderIdsArg)
+{
 	switch (params.resolverContext)
 	{
 		case service::ResolverContext::NotifySubscribe:
 		{
-			if (itr == itrEnd)
+			std::vector<RegistrationKey> subscribed;
+
+			subscribed.reserve(folderIdsArg.size());
+
+			try
+			{
+				for (auto& folderId : folderIdsArg)
+				{
+					RegistrationKey key { convert::input::from_input(std::move(folderId)), {} };
+					auto itr = m_countSinks.find(key);
+
+					if (itr == m_countSinks.end())
+					{
+						CountsRegistration registration;
+
+						RegisterCountsListener(params.launch, key, registration);
+						itr = m_countSinks.emplace(key, std::move(registration)).first;
+					}
+
+					++itr->second.subscribers;
+					subscribed.push_back(std::move(key));
+				}
+			}
+			catch (...)
+			{
+				// The service won't unsubscribe if this fails, so release the folders which were
+				// already counted.
+				for (const auto& key : subscribed)
+				{
+					const auto itr = m_countSinks.find(key);
+
+					if (itr != m_countSinks.end() && --itr->second.subscribers == 0)
+					{
+						m_countSinks.erase(itr);
+					}
+				}
+
+				throw;
+			}
+
+			break;
+		}
+
+		case service::ResolverContext::NotifyUnsubscribe:
+		{
+			for (auto& folderId : folderIdsArg)
+			{
+				const auto itr = m_countSinks.find(
+					RegistrationKey { convert::input::from_input(std::move(folderId)), {} });
+
+				CFRt(itr != m_countSinks.end());
+
+				if (--itr->second.subscribers == 0)
+				{
+					m_countSinks.erase(itr);
+				}
+			}
+
+			break;
+		}
+
+		default:
+		{
+			constexpr bool Unexpected_ResolverContext = false;
+			CFRt(Unexpected_ResolverContext);
+		}
+	}
+
+	return {};
+}
+
+std::optional<int> Subscription::TakeResumeDirective(service::Directives& fieldDirectives)
+{
+	auto result = GetResumeDirective(fieldDirectives);
+
+	if (result)
+	{
+		// Subscribers which resume from different sequences still share the same sink.
+		fieldDirectives.erase(std::remove_if(fieldDirectives.begin(),
+								  fieldDirectives.end(),
+								  [](const auto& entry) noexcept {
+									  return entry.first == "resume"sv;
+								  }),
+			fieldDirectives.end());
+	}
+
+	return result;
+}
+
+std::optional<int> Subscription::GetResumeDirective(const service::Directives& fieldDirectives)
+{
+	const auto itr = std::find_if(fieldDirectives.begin(),
+		fieldDirectives.end(),
+		[](const auto& entry) noexcept {
+			return entry.first == "resume"sv;
+		});
+
+	if (itr == fieldDirectives.end())
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(GetResumeSequence(itr->second));
+}
+
+template <class T>
+void Subscription::AddSubscriber(
+	IdleRegistrations& idle, Registration<T>& registration, std::optional<int> resume) const
+{
+	++registration.subscribers;
+
+	if (registration.idle)
+	{
+		idle.erase(*registration.idle);
+		registration.idle.reset();
+	}
+
+	if (!resume)
+	{
+		return;
+	}
+
+	const auto pSink = registration.sink.get();
+	bool replay = false;
+
+	{
+		std::lock_guard lock { pSink->mutex };
+		auto& state = pSink->resumes[*resume];
+
+		++state.subscribers;
+
+		if (!state.pending)
+		{
+			state.pending = true;
+			replay = true;
+		}
+	}
+
+	if (replay)
+	{
+		// Queue the replay behind any notifications which are already waiting for this sink.
+		Post(pSink, [replay = pSink->replay, after = *resume]() {
+			replay(after);
+		});
+	}
+}
+
+template <class T>
+void Subscription::RemoveSubscriber(Registrations<T>& registrations, IdleRegistrations& idle,
+	typename Registrations<T>::iterator itr, std::optional<int> resume) const
+{
+	auto& registration = itr->second;
+
+	if (resume)
+	{
+		std::lock_guard lock { registration.sink->mutex };
+		const auto itrResume = registration.sink->resumes.find(*resume);
+
+		if (itrResume != registration.sink->resumes.end() && --itrResume->second.subscribers == 0)
+		{
+			registration.sink->resumes.erase(itrResume);
+		}
+	}
+
+	if (--registration.subscribers > 0)
+	{
+		return;
+	}
+
+	if (m_options.resumeHistory == 0 || m_options.retainedSinks == 0)
+	{
+		registrations.erase(itr);
+		return;
+	}
+
+	{
+		// Stop listening to the table, but hold on to the history and the window the listeners
+		// last saw, so subscribers which reconnect can still @resume.
+		std::lock_guard lock { registration.sink->mutex };
+
+		registration.sink->sinkProxy->Unadvise();
+		registration.sink->sinkProxy.Release();
+		registration.sink->table.Release();
+		registration.sink->retired = true;
+
+		if (registration.sink->pendingBaseline)
+		{
+			registration.sink->rows = std::move(*registration.sink->pendingBaseline);
+			registration.sink->pendingBaseline.reset();
+		}
+
+		// Ignore the coalescing window if it's still open.
+		++registration.sink->pendingWindow;
+		registration.sink->pendingCount = 0;
+		registration.sink->pendingReload = false;
+	}
+
+	registration.idle = idle.insert(idle.end(), &itr->first);
+
+	// Release the registrations which have been idle the longest.
+	while (idle.size() > m_options.retainedSinks)
+	{
+		const auto itrOldest = registrations.find(*idle.front());
+
+		idle.pop_front();
+		registrations.erase(itrOldest);
+	}
+}
+
+bool operator==(const ObjectId& lhs, const ObjectId& rhs) noexcept
+{
+	return lhs.storeId == rhs.storeId && lhs.objectId == rhs.objectId;
+}
+
+template <class T>
+struct SubscriptionTraits;
+
+template <>
+struct SubscriptionTraits<Item>
+{
+	using Change = object::ItemChange;
+
+	using Added = ItemAdded;
+	using Updated = ItemUpdated;
+	using Removed = ItemRemoved;
+	using Reloaded = ItemsReloaded;
+
+	using AddedObject = object::ItemAdded;
+	using UpdatedObject = object::ItemUpdated;
+	using RemovedObject = object::ItemRemoved;
+	using ReloadedObject = object::ItemsReloaded;
+
+	// Used to compare the rows from a reload with the rows we already had. Marking an item as
+	// read does not change the last modified time.
+	static bool IsModified(const Item& before, const Item& after) noexcept
+	{
+		return before.read() != after.read()
+			|| ::CompareFileTime(&before.modified(), &after.modified()) != 0;
+	}
+};
+
+template <>
+struct SubscriptionTraits<Folder>
+{
+	using Change = object::FolderChange;
+
+	using Added = FolderAdded;
+	using Updated = FolderUpdated;
+	using Removed = FolderRemoved;
+	using Reloaded = FoldersReloaded;
+
+	using AddedObject = object::FolderAdded;
+	using UpdatedObject = object::FolderUpdated;
+	using RemovedObject = object::FolderRemoved;
+	using ReloadedObject = object::FoldersReloaded;
+
+	// Folders don't have a last modified time in the hierarchy table, so compare all of the
+	// default columns which can change.
+	static bool IsModified(const Folder& before, const Folder& after) noexcept
+	{
+		return before.name() != after.name() || before.count() != after.count()
+			|| before.unread() != after.unread() || before.hasSubfolders() != after.hasSubfolders()
+			|| before.containerClass() != after.containerClass();
+	}
+};
+
+template <class T>
+std::shared_ptr<typename SubscriptionTraits<T>::Change> MakeAdded(
+	int sequence, int index, const std::shared_ptr<T>& added)
+{
+	using Traits = SubscriptionTraits<T>;
+
+	return std::make_shared<typename Traits::Change>(
+		std::make_shared<typename Traits::AddedObject>(
+			std::make_shared<typename Traits::Added>(sequence, index, added)));
+}
+
+template <class T>
+std::shared_ptr<typename SubscriptionTraits<T>::Change> MakeUpdated(int sequence, int index,
+	const std::shared_ptr<T>& updated, const std::shared_ptr<T>& previous)
+{
+	using Traits = SubscriptionTraits<T>;
+
+	return std::make_shared<typename Traits::Change>(
+		std::make_shared<typename Traits::UpdatedObject>(
+			std::make_shared<typename Traits::Updated>(sequence, index, updated, previous)));
+}
+
+template <class T>
+std::shared_ptr<typename SubscriptionTraits<T>::Change> MakeRemoved(
+	int sequence, int index, const response::IdType& removed)
+{
+	using Traits = SubscriptionTraits<T>;
+
+	return std::make_shared<typename Traits::Change>(
+		std::make_shared<typename Traits::RemovedObject>(
+			std::make_shared<typename Traits::Removed>(sequence, index, removed)));
+}
+
+template <class T>
+std::shared_ptr<typename SubscriptionTraits<T>::Change> MakeReloaded(
+	int sequence, const std::vector<std::shared_ptr<T>>& reloaded)
+{
+	using Traits = SubscriptionTraits<T>;
+
+	return std::make_shared<typename Traits::Change>(
+		std::make_shared<typename Traits::ReloadedObject>(
+			std::make_shared<typename Traits::Reloaded>(sequence, reloaded)));
+}
+
+// Compute the net changes which turn the before window into the after window. Rows are matched by
+// PR_INSTANCE_KEY, so a row which was added and removed again in between does not show up at all,
+// and a row which was modified several times is only updated once. Removals are listed from the
+// end of the window, so each index is still valid when the listener applies them in order, and
+// the additions and updates which follow use the final indices in the after window.
+template <class T, class IsModified, class NextSequence>
+std::vector<std::shared_ptr<typename SubscriptionTraits<T>::Change>> DiffRows(
+	const std::vector<std::shared_ptr<T>>& before, const std::vector<std::shared_ptr<T>>& after,
+	IsModified isModified, NextSequence nextSequence)
+{
+	constexpr size_t npos = std::numeric_limits<size_t>::max();
+	std::map<response::IdType, size_t> afterIndices;
+
+	for (size_t i = 0; i < after.size(); ++i)
+	{
+		afterIndices.emplace(after[i]->instanceKey(), i);
+	}
+
+	// Pair up the rows which are in both windows, in the order they appeared before.
+	std::vector<std::pair<size_t, size_t>> matched;
+
+	matched.reserve(std::min(before.size(), after.size()));
+	for (size_t i = 0; i < before.size(); ++i)
+	{
+		const auto itr = afterIndices.find(before[i]->instanceKey());
+
+		if (itr != afterIndices.end())
+		{
+			matched.emplace_back(i, itr->second);
+		}
+	}
+
+	// Keep the longest run of matched rows which are still in the same relative order, anything
+	// else which moved is removed and added again at its new index.
+	std::vector<size_t> tails;
+	std::vector<size_t> previous(matched.size(), npos);
+
+	for (size_t m = 0; m < matched.size(); ++m)
+	{
+		const auto itr = std::lower_bound(tails.begin(),
+			tails.end(),
+			matched[m].second,
+			[&matched](size_t lhs, size_t value) noexcept {
+				return matched[lhs].second < value;
+			});
+
+		if (itr != tails.begin())
+		{
+			previous[m] = *(itr - 1);
+		}
+
+		if (itr == tails.end())
+		{
+			tails.push_back(m);
+		}
+		else
+		{
+			*itr = m;
+		}
+	}
+
+	std::vector<bool> keepBefore(before.size(), false);
+	std::vector<size_t> beforeIndices(after.size(), npos);
+
+	for (auto m = tails.empty() ? npos : tails.back(); m != npos; m = previous[m])
+	{
+		keepBefore[matched[m].first] = true;
+		beforeIndices[matched[m].second] = matched[m].first;
+	}
+
+	std::vector<std::shared_ptr<typename SubscriptionTraits<T>::Change>> changes;
+
+	for (size_t i = before.size(); i-- > 0;)
+	{
+		if (!keepBefore[i])
+		{
+			changes.push_back(
+				MakeRemoved<T>(nextSequence(), static_cast<int>(i), before[i]->id()));
+		}
+	}
+
+	for (size_t i = 0; i < after.size(); ++i)
+	{
+		if (beforeIndices[i] == npos)
+		{
+			changes.push_back(MakeAdded<T>(nextSequence(), static_cast<int>(i), after[i]));
+		}
+	}
+
+	for (size_t i = 0; i < after.size(); ++i)
+	{
+		if (beforeIndices[i] != npos && isModified(before[beforeIndices[i]], after[i]))
+		{
+			changes.push_back(MakeUpdated<T>(nextSequence(),
+				static_cast<int>(i),
+				after[i],
+				before[beforeIndices[i]]));
+		}
+	}
+
+	return changes;
+}
+
+// Every notification replaces the row, so a different pointer means it was modified.
+template <class T>
+bool IsReplaced(const std::shared_ptr<T>& before, const std::shared_ptr<T>& after) noexcept
+{
+	return before != after;
+}
+
+// Reloading creates new rows for everything, so compare the columns which can change instead.
+template <class T>
+bool IsReloadModified(const std::shared_ptr<T>& before, const std::shared_ptr<T>& after) noexcept
+{
+	return SubscriptionTraits<T>::IsModified(*before, *after);
+}
+
+// Translate a reload into the changes since the before window and append them to items. If there
+// are more than the threshold, it's cheaper to send the whole window instead.
+template <class T, class NextSequence>
+void DiffReload(const std::vector<std::shared_ptr<T>>& before,
+	const std::vector<std::shared_ptr<T>>& after, size_t threshold, NextSequence nextSequence,
+	std::vector<std::shared_ptr<typename SubscriptionTraits<T>::Change>>& items)
+{
+	auto changes = DiffRows<T>(before, after, IsReloadModified<T>, nextSequence);
+
+	if (changes.size() > threshold)
+	{
+		// The whole window supersedes anything else in this batch.
+		items.clear();
+		items.push_back(MakeReloaded<T>(nextSequence(), after));
+		return;
+	}
+
+	items.insert(items.end(),
+		std::make_move_iterator(changes.begin()),
+		std::make_move_iterator(changes.end()));
+}
+
+template <class T, class ArgumentType, class PayloadType>
+void Subscription::RegisterAdviseSinkProxy(service::await_async launch, std::string&& fieldName,
+	std::string_view argumentName, const ArgumentType& argumentValue, const RegistrationKey& key,
+	Registration<T>& registration) const
+{
+	using Changes = std::vector<std::shared_ptr<typename SubscriptionTraits<T>::Change>>;
+
+	// A registration which was retained for @resume keeps its sink, so the changes it missed while
+	// nobody was subscribed can be added to the same history.
+	const bool retained = static_cast<bool>(registration.sink);
+
+	if (!retained)
+	{
+		registration.sink = std::make_shared<TableSink<T>>();
+		registration.sink->sequence = m_sequence;
+		registration.sink->evicted = registration.sink->sequence;
+	}
+
+	std::vector<std::shared_ptr<T>> previous;
+
+	{
+		std::lock_guard lock { registration.sink->mutex };
+		auto rows = LoadRows<T>(key, registration.sink->store, registration.sink->table);
+		const auto take = TableDirectives { nullptr, key.directives }.take();
+
+		previous = std::exchange(registration.sink->rows, std::move(rows));
+		registration.sink->take = take > 0 ? static_cast<size_t>(take) : 0;
+		registration.sink->complete = registration.sink->rows.size() < registration.sink->take;
+		registration.sink->retired = false;
+	}
+
+	// The service calls the filter for every subscriber on this field, so build it once per sink
+	// and keep the per-subscriber checks cheap. The sink is identified by the argument and the
+	// table directives in the RegistrationKey, so compare the argument without converting it, and
+	// index those directives by name.
+	auto directiveValues = std::make_shared<std::map<std::string, response::Value, std::less<>>>();
+
+	for (const auto& [directiveName, directiveValue] : key.directives)
+	{
+		directiveValues->emplace(std::string { directiveName }, directiveValue);
+	}
+
+	const service::SubscriptionArgumentFilterCallback argumentsMatch {
+		[argumentName, argumentValue = argumentValue](
+			response::MapType::const_reference required) noexcept -> bool {
+			return required.first == argumentName
+				&& convert::input::matches_input(required.second, argumentValue);
+		}
+	};
+
+	// The sink outlives every delivery, which happen while holding the sink mutex.
+	const auto pSink = registration.sink.get();
+
+	// Subscribers which @resume don't get any changes until their replay has been delivered.
+	const service::RequestDeliverFilter filter { service::SubscriptionFilter { argumentsMatch,
+		service::SubscriptionDirectiveFilterCallback {
+			[directiveValues, pSink](service::Directives::const_reference required) noexcept
+			-> bool {
+				if (required.first == "resume"sv)
+				{
+					const auto itrResume = pSink->resumes.find(GetResumeSequence(required.second));
+
+					return (itrResume != pSink->resumes.end() && !itrResume->second.pending);
+				}
+
+				const auto itrDirective = directiveValues->find(required.first);
+
+				return (itrDirective != directiveValues->end()
+					&& itrDirective->second == required.second);
+			} } } };
+
+	// Remember the batches we deliver, so subscribers which @resume can catch up. The caller must
+	// hold the sink mutex.
+	auto record = [resumeHistory = m_options.resumeHistory](TableSink<T>& sink,
+					  const Changes& items) {
+		if (resumeHistory == 0 || items.empty())
+		{
+			return;
+		}
+
+		sink.history.emplace_back(sink.sequence, items);
+		sink.historySize += items.size();
+
+		while (sink.historySize > resumeHistory)
+		{
+			sink.evicted = sink.history.front().first;
+			sink.historySize -= sink.history.front().second.size();
+			sink.history.pop_front();
+		}
+	};
+
+	// Deliver a batch of changes to the listeners on the service with matching arguments and
+	// directives.
+	auto deliver = std::make_shared<std::function<void(TableSink<T>&, Operations&, Changes&&)>>(
+		[launch, fieldName, filter, record](TableSink<T>& sink,
+			Operations& service,
+			Changes&& items) {
+			record(sink, items);
+			std::ignore = service.deliver({ fieldName,
+				filter,
+				launch,
+				std::make_shared<object::Subscription>(
+					std::make_shared<PayloadType>(std::move(items))) });
+		});
+
+	// Changes are numbered in the order they're delivered. The caller must hold the sink mutex.
+	const auto sequencer = [](const Subscription& self, TableSink<T>& sink) noexcept {
+		return [&self, &sink]() noexcept {
+			sink.sequence = NextSequence(self.m_sequence);
+			return sink.sequence;
+		};
+	};
+
+	// Deliver the net changes since the coalescing window opened. The caller must hold the sink
+	// mutex.
+	auto flush = [deliver, sequencer, reloadDiffThreshold = m_options.reloadDiffThreshold](
+					 const Subscription& self,
+					 TableSink<T>& sink,
+					 Operations& service) {
+		if (!sink.pendingBaseline)
+		{
+			return;
+		}
+
+		Changes items;
+
+		if (sink.pendingReload)
+		{
+			DiffReload<T>(*sink.pendingBaseline,
+				sink.rows,
+				reloadDiffThreshold,
+				sequencer(self, sink),
+				items);
+		}
+		else
+		{
+			items = DiffRows<T>(*sink.pendingBaseline,
+				sink.rows,
+				IsReplaced<T>,
+				sequencer(self, sink));
+		}
+
+		sink.pendingBaseline.reset();
+		sink.pendingCount = 0;
+		sink.pendingReload = false;
+
+		if (!items.empty())
+		{
+			(*deliver)(sink, service, std::move(items));
+		}
+	};
+
+	if (retained)
+	{
+		// Nobody was listening while the registration was retained, so just add what changed in
+		// the meantime to the history for the subscribers which @resume.
+		std::lock_guard lock { registration.sink->mutex };
+		Changes items;
+
+		DiffReload<T>(previous,
+			registration.sink->rows,
+			m_options.reloadDiffThreshold,
+			sequencer(*this, *registration.sink),
+			items);
+		record(*registration.sink, items);
+	}
+
+	const std::weak_ptr<const Subscription> wpThis { shared_from_this() };
+	const std::weak_ptr<TableSink<T>> wpSink { registration.sink };
+
+	// Flush a coalescing window when it closes, unless the threshold already flushed it.
+	auto flushWindow = [wpThis, wpSink, flush](size_t window) {
+		auto spThis = wpThis.lock();
+		auto spSink = wpSink.lock();
+
+		if (!spThis || !spSink)
+		{
+			return;
+		}
+
+		auto spService = spThis->m_service.lock();
+
+		if (!spService)
+		{
+			return;
+		}
+
+		std::lock_guard lock { spSink->mutex };
+
+		if (spSink->pendingWindow == window)
+		{
+			flush(*spThis, *spSink, *spService);
+		}
+	};
+
+	// Apply a batch of table notifications to the cached window, and either deliver the changes
+	// right away or collect them until the coalescing window closes.
+	auto process = [key, wpThis, wpSink, deliver, sequencer, flush, flushWindow](
+					   std::vector<TableNotification>& notifications) {
+		auto spThis = wpThis.lock();
+		auto spSink = wpSink.lock();
+
+		if (!spThis || !spSink)
+		{
+			return;
+		}
+
+		auto spService = spThis->m_service.lock();
+
+		if (!spService)
+		{
+			return;
+		}
+
+		std::lock_guard lock { spSink->mutex };
+
+		if (spSink->retired)
+		{
+			// The last subscriber left while these notifications were queued.
+			return;
+		}
+
+		const bool coalesce = spThis->m_options.coalesceWindow.count() > 0;
+		const auto nextSequence = sequencer(*spThis, *spSink);
+
+		if (coalesce && !spSink->pendingBaseline)
+		{
+			// Open a new window, and remember what the listeners last saw so we can deliver the
+			// net changes when it closes.
+			const size_t window = ++spSink->pendingWindow;
+
+			spSink->pendingBaseline = spSink->rows;
+			spThis->m_timerQueue->schedule(
+				TimerQueue::Clock::now() + spThis->m_options.coalesceWindow,
+				[wpThis, wpSink, flushWindow, window]() {
+					auto spThis = wpThis.lock();
+					auto spSink = wpSink.lock();
+
+					if (!spThis || !spSink)
+					{
+						return;
+					}
+
+					spThis->Post(spSink.get(), [flushWindow, window]() {
+						flushWindow(window);
+					});
+				});
+		}
+
+		Changes items;
+
+		if (!coalesce)
+		{
+			items.reserve(notifications.size());
+		}
+
+		for (auto& notif : notifications)
+		{
+			bool reload = false;
+
+			switch (notif.tableEvent)
+			{
+				case TABLE_CHANGED:
+				case TABLE_ERROR:
+				case TABLE_RELOAD:
+					reload = true;
+					break;
+
+				case TABLE_ROW_ADDED:
+				{
+					if (notif.indexKey
+						&& std::find_if(spSink->rows.begin(),
+							   spSink->rows.end(),
+							   [&indexKey = *notif.indexKey](
+								   const std::shared_ptr<T>& item) noexcept {
+								   return item->instanceKey() == indexKey;
+							   })
+							!= spSink->rows.end())
+					{
+						// We already read this row when we backfilled the window.
+						break;
+					}
+
+					// Find the insertion point if it's in our cache window.
+					auto itr = spSink->rows.end();
+
+					if (notif.priorKey)
+					{
+						const auto itrPrior = std::find_if(spSink->rows.begin(),
+							spSink->rows.end(),
+							[&priorKey = *notif.priorKey](const std::shared_ptr<T>& item) noexcept {
+								return item->instanceKey() == priorKey;
+							});
+
+						if (itrPrior == spSink->rows.end())
+						{
+							break;
+						}
+
+						itr = itrPrior + 1;
+					}
+					else if (notif.addedFirst)
+					{
+						itr = spSink->rows.begin();
+					}
+					else
+					{
+						break;
+					}
+
+					const auto index = static_cast<int>(std::distance(spSink->rows.begin(), itr));
+
+					if (spSink->take > 0 && static_cast<size_t>(index) >= spSink->take)
+					{
+						// It belongs past the end of a full window.
+						spSink->complete = false;
+						break;
+					}
+
+					auto item = std::make_shared<T>(spSink->store,
+						nullptr,
+						notif.columnCount,
+						std::move(notif.columns));
+
+					spSink->rows.insert(itr, item);
+
+					if (!coalesce)
+					{
+						items.push_back(MakeAdded<T>(nextSequence(), index, item));
+					}
+
+					if (spSink->take > 0 && spSink->rows.size() > spSink->take)
+					{
+						// Push the last row out of the window to keep it the same size.
+						const response::IdType lastId = spSink->rows.back()->id();
+
+						spSink->rows.pop_back();
+						spSink->complete = false;
+
+						if (!coalesce)
+						{
+							items.push_back(MakeRemoved<T>(nextSequence(),
+								static_cast<int>(spSink->rows.size()),
+								lastId));
+						}
+					}
+
+					break;
+				}
+
+				case TABLE_ROW_MODIFIED:
+				{
+					if (!notif.indexKey)
+					{
+						break;
+					}
+
+					const auto itr = std::find_if(spSink->rows.begin(),
+						spSink->rows.end(),
+						[&indexKey = *notif.indexKey](const std::shared_ptr<T>& item) noexcept {
+							return item->instanceKey() == indexKey;
+						});
+
+					if (itr == spSink->rows.end())
+					{
+						break;
+					}
+
+					const auto index = static_cast<int>(std::distance(spSink->rows.begin(), itr));
+					auto item = std::make_shared<T>(spSink->store,
+						nullptr,
+						notif.columnCount,
+						std::move(notif.columns));
+
+					auto previous = std::exchange(*itr, item);
+
+					if (!coalesce)
+					{
+						items.push_back(MakeUpdated<T>(nextSequence(), index, item, previous));
+					}
+
+					break;
+				}
+
+				case TABLE_ROW_DELETED:
+				{
+					if (!notif.indexKey)
+					{
+						break;
+					}
+
+					const auto itr = std::find_if(spSink->rows.begin(),
+						spSink->rows.end(),
+						[&indexKey = *notif.indexKey](const std::shared_ptr<T>& item) noexcept {
+							return item->instanceKey() == indexKey;
+						});
+
+					if (itr == spSink->rows.end())
+					{
+						break;
+					}
+
+					const auto index = static_cast<int>(std::distance(spSink->rows.begin(), itr));
+					const response::IdType itemId = (*itr)->id();
+
+					spSink->rows.erase(itr);
+
+					if (!coalesce)
+					{
+						items.push_back(MakeRemoved<T>(nextSequence(), index, itemId));
+					}
+
+					break;
+				}
+			}
+
+			if (reload)
+			{
+				auto rows = spThis->LoadRows<T>(key, spSink->store, spSink->table);
+
+				if (coalesce)
+				{
+					spSink->pendingReload = true;
+				}
+				else
+				{
+					// The changes we already collected in this batch are reflected in the rows, so
+					// the listeners can apply the diff right after them.
+					DiffReload<T>(spSink->rows,
+						rows,
+						spThis->m_options.reloadDiffThreshold,
+						nextSequence,
+						items);
+				}
+
+				spSink->rows = std::move(rows);
+				spSink->complete = spSink->rows.size() < spSink->take;
+				break;
+			}
+		}
+
+		if (spSink->rows.size() < spSink->take && !spSink->complete)
+		{
+			// Rows left the window, or they were added past the end of it while it was short. Fill
+			// it back up from the table instead of reloading the whole window.
+			const auto backfill = spThis->BackfillRows<T>(key, *spSink);
+
+			if (!coalesce)
+			{
+				auto index = static_cast<int>(spSink->rows.size() - backfill.size());
+
+				for (const auto& row : backfill)
+				{
+					items.push_back(MakeAdded<T>(nextSequence(), index++, row));
+				}
+			}
+		}
+
+		if (coalesce)
+		{
+			spSink->pendingCount += notifications.size();
+
+			if (spThis->m_options.coalesceThreshold > 0
+				&& spSink->pendingCount >= spThis->m_options.coalesceThreshold)
+			{
+				flush(*spThis, *spSink, *spService);
+			}
+		}
+		else if (!items.empty())
+		{
+			(*deliver)(*spSink, *spService, std::move(items));
+		}
+	};
+
+	// Deliver the changes after a sequence to the subscribers which @resume from it. The service
+	// can't single them out, so any other subscribers on this sink resolve the payload to an empty
+	// list.
+	registration.sink->replay =
+		[wpThis, wpSink, launch, fieldName, argumentsMatch, directiveValues](int after) {
+			auto spThis = wpThis.lock();
+			auto spSink = wpSink.lock();
+
+			if (!spThis || !spSink)
+			{
+				return;
+			}
+
+			auto spService = spThis->m_service.lock();
+
+			if (!spService)
+			{
+				return;
+			}
+
+			std::lock_guard lock { spSink->mutex };
+			const auto itrResume = spSink->resumes.find(after);
+
+			if (itrResume == spSink->resumes.end() || !itrResume->second.pending)
+			{
+				return;
+			}
+
+			itrResume->second.pending = false;
+
+			Changes items;
+			const auto distance = SequenceDistance(spSink->sequence, after);
+
+			if (after < 0 || distance > SequenceDistance(spSink->sequence, spSink->evicted))
+			{
+				// We don't have all of the changes since then, or it's a sequence we never
+				// delivered, so send the window the other subscribers last saw instead.
+				items.push_back(MakeReloaded<T>(spSink->sequence,
+					spSink->pendingBaseline ? *spSink->pendingBaseline : spSink->rows));
+			}
+			else
+			{
+				for (const auto& [batchSequence, batch] : spSink->history)
+				{
+					if (SequenceDistance(spSink->sequence, batchSequence) < distance)
+					{
+						items.insert(items.end(), batch.begin(), batch.end());
+					}
+				}
+			}
+
+			if (items.empty())
+			{
+				return;
+			}
+
+			const service::RequestDeliverFilter replayFilter { service::SubscriptionFilter {
+				argumentsMatch,
+				service::SubscriptionDirectiveFilterCallback {
+					[directiveValues, after](service::Directives::const_reference required) noexcept
+					-> bool {
+						if (required.first == "resume"sv)
+						{
+							return GetResumeSequence(required.second) == after;
+						}
+
+						const auto itrDirective = directiveValues->find(required.first);
+
+						return (itrDirective != directiveValues->end()
+							&& itrDirective->second == required.second);
+					} } } };
+
+			std::ignore = spService->deliver({ fieldName,
+				replayFilter,
+				launch,
+				std::make_shared<object::Subscription>(
+					std::make_shared<PayloadType>(std::move(items), std::make_optional(after))) });
+		};
+
+	CComPtr<AdviseSinkProxy<IMAPITable>> sinkProxy;
+	ULONG_PTR connectionId = 0;
+
+	sinkProxy.Attach(new AdviseSinkProxy<IMAPITable>(
+		[wpThis, wpSink, process](size_t count, LPNOTIFICATION pNotifications) {
+			if (0 == count || nullptr == pNotifications)
 			{
-				RegisterAdviseSinkProxy<Folder, response::IdType, RootFoldersSubscription>(
-					params.launch,
-					"rootFolders"s,
-					"storeId"sv,
-					registration.key.objectId.storeId,
-					registration);
+				return;
 			}
-			else
+
+			auto spThis = wpThis.lock();
+			auto spSink = wpSink.lock();
+
+			if (!spThis || !spSink)
 			{
-				registration.sink = itr->sink;
+				return;
 			}
 
-			m_rootFolderSinks.insert(itrEnd, std::move(registration));
-			break;
-		}
+			// MAPI frees the notifications as soon as we return, so we need to copy them before
+			// handing them to the notification queue.
+			auto notifications = std::make_shared<std::vector<TableNotification>>();
 
-		case service::ResolverContext::NotifyUnsubscribe:
-		{
-			CFRt(itr != itrEnd);
-			m_rootFolderSinks.erase(itr);
-			break;
-		}
+			notifications->reserve(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				notifications->emplace_back(pNotifications[i].info.tab);
+			}
 
-		default:
-		{
-			constexpr bool Unexpected_ResolverContext = false;
-			CFRt(Unexpected_ResolverContext);
-		}
-	}
+			if (!spThis->m_notificationQueue)
+			{
+				process(*notifications);
+				return;
+			}
 
-	return {};
-}
+			spThis->m_notificationQueue->push(
+				spSink.get(),
+				[process, notifications]() {
+					process(*notifications);
+				},
+				[process]() {
+					// Some of the notifications were dropped, so reload the table and deliver the
+					// difference instead.
+					std::vector<TableNotification> reload;
+
+					reload.emplace_back(TABLE_RELOAD);
+					process(reload);
+				});
+		}));
 
-bool operator==(const ObjectId& lhs, const ObjectId& rhs) noexcept
-{
-	return lhs.storeId == rhs.storeId && lhs.objectId == rhs.objectId;
+	CORt(registration.sink->table->Advise(fnevTableModified, sinkProxy, &connectionId));
+	sinkProxy->OnAdvise(registration.sink->table, connectionId);
+	registration.sink->sinkProxy.Attach(sinkProxy.Detach());
 }
 
-template <class T>
-struct SubscriptionTraits;
-
-template <>
-struct SubscriptionTraits<Item>
+void Subscription::RegisterCountsListener(service::await_async launch,
+	const RegistrationKey& key, CountsRegistration& registration) const
 {
-	using Change = object::ItemChange;
+	auto store = m_query->lookup(key.objectId.storeId);
 
-	using Added = ItemAdded;
-	using Updated = ItemUpdated;
-	using Removed = ItemRemoved;
-	using Reloaded = ItemsReloaded;
+	CFRt(store != nullptr);
 
-	using AddedObject = object::ItemAdded;
-	using UpdatedObject = object::ItemUpdated;
-	using RemovedObject = object::ItemRemoved;
-	using ReloadedObject = object::ItemsReloaded;
-};
+	auto folder = store->OpenFolder(key.objectId.objectId);
 
-template <>
-struct SubscriptionTraits<Folder>
-{
-	using Change = object::FolderChange;
+	CFRt(folder != nullptr);
 
-	using Added = FolderAdded;
-	using Updated = FolderUpdated;
-	using Removed = FolderRemoved;
-	using Reloaded = FoldersReloaded;
+	if (!m_timerQueue && m_options.folderCountsInterval.count() > 0)
+	{
+		// Only start the timer thread once something needs to rate limit the reads. The listeners
+		// are the only ones which use it without coalescing, and they're all added after this.
+		m_timerQueue = std::make_unique<TimerQueue>();
+	}
 
-	using AddedObject = object::FolderAdded;
-	using UpdatedObject = object::FolderUpdated;
-	using RemovedObject = object::FolderRemoved;
-	using ReloadedObject = object::FoldersReloaded;
-};
+	registration.sink = std::make_shared<CountsSink>();
+	registration.sink->folder = folder;
+	registration.sink->count = folder->count();
+	registration.sink->unread = folder->unread();
+
+	// Every subscriber which includes this folder in its folderIds gets the new counts.
+	const service::RequestDeliverFilter filter { service::SubscriptionFilter {
+		service::SubscriptionArgumentFilterCallback {
+			[folderId = key.objectId](response::MapType::const_reference required) noexcept
+			-> bool {
+				if (required.first != "folderIds"sv)
+				{
+					return false;
+				}
 
-template <class T, class ArgumentType, class PayloadType>
-void Subscription::RegisterAdviseSinkProxy(service::await_async launch, std::string&& fieldName,
-	std::string_view argumentName, const ArgumentType& argumentValue,
-	Registration<T>& registration) const
-{
-	registration.sink = std::make_shared<TableSink<T>>();
-	registration.sink->rows =
-		LoadRows<T>(registration.key, registration.sink->store, registration.sink->table);
+				const auto folderIds =
+					service::ModifiedArgument<ObjectId>::convert<service::TypeModifier::List>(
+						required.second);
 
-	auto spThis = shared_from_this();
-	CComPtr<AdviseSinkProxy<IMAPITable>> sinkProxy;
-	ULONG_PTR connectionId = 0;
+				return std::find(folderIds.begin(), folderIds.end(), folderId) != folderIds.end();
+			} },
+		service::SubscriptionDirectiveFilterCallback {
+			[](service::Directives::const_reference) noexcept -> bool {
+				return true;
+			} } } };
 
-	sinkProxy.Attach(new AdviseSinkProxy<IMAPITable>([launch,
-														 fieldName = std::move(fieldName),
-														 argumentName,
-														 argumentValue = argumentValue,
-														 key = registration.key,
-														 wpThis = std::weak_ptr { spThis },
-														 wpSink =
-															 std::weak_ptr { registration.sink }](
-														 size_t count,
-														 LPNOTIFICATION pNotifications) {
-		if (0 == count || nullptr == pNotifications)
-		{
-			return;
-		}
+	const std::weak_ptr<const Subscription> wpThis { shared_from_this() };
+	const std::weak_ptr<CountsSink> wpSink { registration.sink };
 
+	// Read the counts, and deliver them if they changed since the listeners last saw them.
+	auto read = [launch, folderId = key.objectId, filter, wpThis, wpSink]() {
 		auto spThis = wpThis.lock();
 		auto spSink = wpSink.lock();
 
@@ -260,224 +1391,152 @@ void Subscription::RegisterAdviseSinkProxy(service::await_async launch, std::str
 			return;
 		}
 
-		std::vector<std::shared_ptr<typename SubscriptionTraits<T>::Change>> items;
-
-		items.reserve(count);
-		for (size_t i = 0; i < count; ++i)
-		{
-			const auto& notif = pNotifications[i];
-			bool reload = false;
-
-			switch (notif.info.tab.ulTableEvent)
-			{
-				case TABLE_CHANGED:
-				case TABLE_ERROR:
-				case TABLE_RELOAD:
-					reload = true;
-					break;
+		std::lock_guard lock { spSink->mutex };
 
-				case TABLE_ROW_ADDED:
-					if (notif.info.tab.propPrior.ulPropTag == PR_INSTANCE_KEY)
-					{
-						// Find the insertion point if it's in our cache window.
-						const auto beginKey = reinterpret_cast<const std::uint8_t*>(
-							notif.info.tab.propPrior.Value.bin.lpb);
-						const auto endKey =
-							beginKey + static_cast<size_t>(notif.info.tab.propPrior.Value.bin.cb);
-						const response::IdType priorKey { beginKey, endKey };
-						const auto itrPrior = std::find_if(spSink->rows.cbegin(),
-							spSink->rows.cend(),
-							[&priorKey](const std::shared_ptr<T>& item) noexcept {
-								return item->instanceKey() == priorKey;
-							});
+		// Anything which changes after this point needs another read.
+		spSink->scheduled = false;
+		spSink->nextRead = TimerQueue::Clock::now() + spThis->m_options.folderCountsInterval;
 
-						if (itrPrior == spSink->rows.cend())
-						{
-							break;
-						}
+		SizedSPropTagArray(2, countProps) = { 2, { PR_CONTENT_COUNT, PR_CONTENT_UNREAD } };
+		ULONG cValues = 0;
+		mapi_ptr<SPropValue> values;
 
-						const auto& row = notif.info.tab.row;
-						const size_t columnCount = static_cast<size_t>(row.cValues);
-						mapi_ptr<SPropValue> columns;
-
-						CORt(ScDupPropset(row.cValues,
-							row.lpProps,
-							::MAPIAllocateBuffer,
-							&out_ptr { columns }));
-						CFRt(columns != nullptr);
-
-						const auto itr = itrPrior + 1;
-						const auto index =
-							static_cast<int>(std::distance(spSink->rows.cbegin(), itr));
-						auto item = std::make_shared<T>(spSink->store,
-							nullptr,
-							columnCount,
-							std::move(columns));
-
-						spSink->rows.insert(itr, item);
-						items.push_back(std::make_shared<typename SubscriptionTraits<T>::Change>(
-							std::make_shared<typename SubscriptionTraits<T>::AddedObject>(
-								std::make_shared<typename SubscriptionTraits<T>::Added>(index,
-									std::move(item)))));
-					}
-                    else if (notif.info.tab.propPrior.ulPropTag == PR_NULL) // new 0th row
-                    {
-						const auto& row = notif.info.tab.row;
-						const size_t columnCount = static_cast<size_t>(row.cValues);
-						mapi_ptr<SPropValue> columns;
-
-						CORt(ScDupPropset(row.cValues,
-							row.lpProps,
-							::MAPIAllocateBuffer,
-							&out_ptr { columns }));
-						CFRt(columns != nullptr);
-
-                        const int index = 0;
-						auto item = std::make_shared<T>(spSink->store,
-							nullptr,
-							columnCount,
-							std::move(columns));
-
-						spSink->rows.insert(spSink->rows.begin(), item);
-						items.push_back(std::make_shared<typename SubscriptionTraits<T>::Change>(
-							std::make_shared<typename SubscriptionTraits<T>::AddedObject>(
-								std::make_shared<typename SubscriptionTraits<T>::Added>(index,
-									std::move(item)))));
-					}
-                    // TODO: don't we need to handle the case where propPrior == PT_NULL? i.e. added
-                    // row is the new 1st row in the table? Don't we need to either update our cache or reload?
+		CORt(spSink->folder->folder()->GetProps(reinterpret_cast<LPSPropTagArray>(&countProps),
+			MAPI_UNICODE,
+			&cValues,
+			&out_ptr { values }));
+		CFRt(cValues == countProps.cValues);
+		CFRt(values != nullptr);
 
-					break;
+		const int count = values.get()[0].ulPropTag == PR_CONTENT_COUNT
+			? static_cast<int>(values.get()[0].Value.l)
+			: spSink->count;
+		const int unread = values.get()[1].ulPropTag == PR_CONTENT_UNREAD
+			? static_cast<int>(values.get()[1].Value.l)
+			: spSink->unread;
 
-				case TABLE_ROW_MODIFIED:
-					if (notif.info.tab.propIndex.ulPropTag == PR_INSTANCE_KEY)
-					{
-						// Find the insertion point if it's in our cache window.
-						const auto beginKey = reinterpret_cast<const std::uint8_t*>(
-							notif.info.tab.propIndex.Value.bin.lpb);
-						const auto endKey =
-							beginKey + static_cast<size_t>(notif.info.tab.propIndex.Value.bin.cb);
-						const response::IdType indexKey { beginKey, endKey };
-						const auto itr = std::find_if(spSink->rows.begin(),
-							spSink->rows.end(),
-							[&indexKey](const std::shared_ptr<T>& item) noexcept {
-								return item->instanceKey() == indexKey;
-							});
+		if (count == spSink->count && unread == spSink->unread)
+		{
+			// Something else changed on the folder.
+			return;
+		}
 
-						if (itr == spSink->rows.cend())
-						{
-							break;
-						}
+		spSink->count = count;
+		spSink->unread = unread;
 
-						const auto& row = notif.info.tab.row;
-						const size_t columnCount = static_cast<size_t>(row.cValues);
-						mapi_ptr<SPropValue> columns;
-
-						CORt(ScDupPropset(row.cValues,
-							row.lpProps,
-							::MAPIAllocateBuffer,
-							&out_ptr { columns }));
-						CFRt(columns != nullptr);
-
-						const auto index =
-							static_cast<int>(std::distance(spSink->rows.begin(), itr));
-						auto item = std::make_shared<T>(spSink->store,
-							nullptr,
-							columnCount,
-							std::move(columns));
-
-						*itr = item;
-						items.push_back(std::make_shared<typename SubscriptionTraits<T>::Change>(
-							std::make_shared<typename SubscriptionTraits<T>::UpdatedObject>(
-								std::make_shared<typename SubscriptionTraits<T>::Updated>(index,
-									std::move(item)))));
-					}
+		std::vector<std::shared_ptr<object::FolderCounts>> folderCounts {
+			std::make_shared<object::FolderCounts>(
+				std::make_shared<FolderCounts>(folderId, count, unread))
+		};
 
-					break;
+		std::ignore = spService->deliver({ "folderCounts"s,
+			filter,
+			launch,
+			std::make_shared<object::Subscription>(
+				std::make_shared<FolderCountsSubscription>(std::move(folderCounts))) });
+	};
 
-				case TABLE_ROW_DELETED:
-					if (notif.info.tab.propIndex.ulPropTag == PR_INSTANCE_KEY)
-					{
-						// Find the insertion point if it's in our cache window.
-						const auto beginKey = reinterpret_cast<const std::uint8_t*>(
-							notif.info.tab.propIndex.Value.bin.lpb);
-						const auto endKey =
-							beginKey + static_cast<size_t>(notif.info.tab.propIndex.Value.bin.cb);
-						const response::IdType indexKey { beginKey, endKey };
-						const auto itr = std::find_if(spSink->rows.cbegin(),
-							spSink->rows.cend(),
-							[&indexKey](const std::shared_ptr<T>& item) noexcept {
-								return item->instanceKey() == indexKey;
-							});
+	// Only read the counts once per interval, a read which is already scheduled picks up any
+	// changes before it runs.
+	registration.sink->listener = store->notifications()->watch(folder->id(),
+		MAPI_FOLDER,
+		[wpThis, wpSink, read](const NOTIFICATION&) {
+			auto spThis = wpThis.lock();
+			auto spSink = wpSink.lock();
 
-						if (itr == spSink->rows.cend())
-						{
-							break;
-						}
+			if (!spThis || !spSink)
+			{
+				return;
+			}
 
-						const auto index =
-							static_cast<int>(std::distance(spSink->rows.cbegin(), itr));
+			TimerQueue::Clock::time_point nextRead;
 
-                        const response::IdType itemId = (*itr)->id();
+			{
+				std::lock_guard lock { spSink->mutex };
 
-						spSink->rows.erase(itr);
-						items.push_back(std::make_shared<typename SubscriptionTraits<T>::Change>(
-							std::make_shared<typename SubscriptionTraits<T>::RemovedObject>(
-								std::make_shared<typename SubscriptionTraits<T>::Removed>(index, itemId))));
-					}
+				if (spSink->scheduled)
+				{
+					return;
+				}
 
-					break;
+				spSink->scheduled = true;
+				nextRead = spSink->nextRead;
 			}
 
-			if (reload)
+			if (!spThis->m_timerQueue || TimerQueue::Clock::now() >= nextRead)
 			{
-				items.clear();
-				spSink->rows = spThis->LoadRows<T>(key, spSink->store, spSink->table);
-				items.push_back(std::make_shared<typename SubscriptionTraits<T>::Change>(
-					std::make_shared<typename SubscriptionTraits<T>::ReloadedObject>(
-						std::make_shared<typename SubscriptionTraits<T>::Reloaded>(spSink->rows))));
-				break;
+				spThis->Post(spSink.get(), read);
+				return;
 			}
-		}
 
-		if (!items.empty())
-		{
-			service::SubscriptionArgumentFilterCallback argumentsMatch =
-				[argumentName, &argumentValue, &key](
-					response::MapType::const_reference required) noexcept -> bool {
-				if (required.first != argumentName)
+			spThis->m_timerQueue->schedule(nextRead, [wpThis, wpSink, read]() {
+				auto spThis = wpThis.lock();
+				auto spSink = wpSink.lock();
+
+				if (!spThis || !spSink)
 				{
-					return false;
+					return;
 				}
 
-				const auto matchValue = service::Argument<ArgumentType>::convert(required.second);
-
-				return matchValue == argumentValue;
-			};
+				spThis->Post(spSink.get(), read);
+			});
+		});
+}
 
-			service::SubscriptionDirectiveFilterCallback directivesMatch =
-				[&key](service::Directives::const_reference required) noexcept -> bool {
-				const auto itrDirective = std::find_if(key.directives.cbegin(),
-					key.directives.cend(),
-					[directiveName = required.first](const auto& directive) noexcept {
-						return directiveName == directive.first;
-					});
+void Subscription::Post(const void* key, std::function<void()>&& callback) const
+{
+	if (m_notificationQueue)
+	{
+		m_notificationQueue->post(key, std::move(callback));
+	}
+	else
+	{
+		callback();
+	}
+}
 
-				return (itrDirective != key.directives.end()
-					&& itrDirective->second == required.second);
-			};
+Subscription::TableNotification::TableNotification(ULONG event) noexcept
+	: tableEvent { event }
+{
+}
 
-			std::ignore = spService->deliver({ fieldName,
-				{ service::SubscriptionFilter { argumentsMatch, directivesMatch } },
-				launch,
-				std::make_shared<object::Subscription>(
-					std::make_shared<PayloadType>(std::move(items))) });
+Subscription::TableNotification::TableNotification(const TABLE_NOTIFICATION& notif)
+	: tableEvent { notif.ulTableEvent }
+	, indexKey { CopyInstanceKey(notif.propIndex) }
+	, priorKey { CopyInstanceKey(notif.propPrior) }
+	, addedFirst { notif.ulTableEvent == TABLE_ROW_ADDED && notif.propPrior.ulPropTag == PR_NULL }
+{
+	switch (tableEvent)
+	{
+		case TABLE_ROW_ADDED:
+		case TABLE_ROW_MODIFIED:
+		{
+			columnCount = static_cast<size_t>(notif.row.cValues);
+			CORt(ScDupPropset(notif.row.cValues,
+				notif.row.lpProps,
+				::MAPIAllocateBuffer,
+				&out_ptr { columns }));
+			CFRt(columns != nullptr);
+			break;
 		}
-	}));
 
-	CORt(registration.sink->table->Advise(fnevTableModified, sinkProxy, &connectionId));
-	sinkProxy->OnAdvise(registration.sink->table, connectionId);
-	registration.sink->sinkProxy.Attach(sinkProxy.Detach());
+		default:
+			break;
+	}
+}
+
+std::optional<response::IdType> Subscription::TableNotification::CopyInstanceKey(
+	const SPropValue& prop)
+{
+	if (prop.ulPropTag != PR_INSTANCE_KEY)
+	{
+		return std::nullopt;
+	}
+
+	const auto beginKey = reinterpret_cast<const std::uint8_t*>(prop.Value.bin.lpb);
+	const auto endKey = beginKey + static_cast<size_t>(prop.Value.bin.cb);
+
+	return response::IdType { beginKey, endKey };
 }
 
 template <>
@@ -600,226 +1659,84 @@ std::vector<std::shared_ptr<Folder>> Subscription::LoadRows<Folder>(
 	return folders;
 }
 
-bool operator<(const ObjectId& lhs, const ObjectId& rhs) noexcept
-{
-	if (lhs.storeId < rhs.storeId)
-	{
-		return true;
-	}
-	else if (rhs.storeId < lhs.storeId)
-	{
-		return false;
-	}
-
-	return (lhs.objectId < rhs.objectId);
-}
-
-bool operator<(const PropIdInput& lhs, const PropIdInput& rhs)
-{
-	if (lhs.id || rhs.id)
-	{
-		if (!lhs.id)
-		{
-			CFRt(lhs.named);
-			CFRt(rhs.id && !rhs.named);
-			return true;
-		}
-		else if (!rhs.id)
-		{
-			CFRt(!lhs.named);
-			CFRt(!rhs.id && rhs.named);
-			return false;
-		}
-
-		return *lhs.id < *rhs.id;
-	}
-
-	CFRt(lhs.named && rhs.named);
-	CFRt(lhs.named->propset.type() == response::Type::String);
-	CFRt(rhs.named->propset.type() == response::Type::String);
-
-	const auto lhsPropset = convert::guid::from_string(lhs.named->propset.get<std::string>());
-	const auto rhsPropset = convert::guid::from_string(rhs.named->propset.get<std::string>());
-	const auto comparePropset = memcmp(&lhsPropset, &rhsPropset, sizeof(lhsPropset));
-
-	if (comparePropset < 0)
-	{
-		return true;
-	}
-	else if (comparePropset > 0)
-	{
-		return false;
-	}
-
-	if (lhs.named->id || rhs.named->id)
-	{
-		if (!lhs.named->id)
-		{
-			CFRt(lhs.named->name);
-			CFRt(rhs.named->id && !rhs.named->name);
-			return true;
-		}
-		else if (!rhs.named->id)
-		{
-			CFRt(!lhs.named->name);
-			CFRt(!rhs.named->id && rhs.named->name);
-			return false;
-		}
-
-		return *lhs.named->id < *rhs.named->id;
-	}
-
-	CFRt(lhs.named->name && rhs.named->name);
-
-	return *lhs.named->name < *rhs.named->name;
-}
-
-bool operator<(const Column& lhs, const Column& rhs)
-{
-	if (lhs.type < rhs.type)
-	{
-		return true;
-	}
-	else if (rhs.type < lhs.type)
-	{
-		return false;
-	}
-
-	return lhs.property < rhs.property;
-}
-
-bool operator<(const Order& lhs, const Order& rhs)
+Subscription::RegistrationKey::RegistrationKey(
+	ObjectId&& objectIdArg, service::Directives&& directivesArg)
+	: objectId { std::move(objectIdArg) }
+	, directives { std::move(directivesArg) }
 {
-	if (lhs.descending != rhs.descending)
-	{
-		return lhs.descending;
-	}
-
-	if (lhs.type < rhs.type)
-	{
-		return true;
-	}
-	else if (rhs.type < lhs.type)
-	{
-		return false;
-	}
+	const auto appendBytes = [this](const response::IdType& bytes) {
+		const auto size = static_cast<std::uint64_t>(bytes.size());
 
-	return lhs.property < rhs.property;
+		canonical.append(reinterpret_cast<const char*>(&size), sizeof(size));
+		canonical.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	};
+	const auto directivesKey = TableDirectives { nullptr, directives }.canonicalKey();
+
+	canonical.reserve(2 * sizeof(std::uint64_t) + objectId.storeId.size()
+		+ objectId.objectId.size() + directivesKey.size());
+	appendBytes(objectId.storeId);
+	appendBytes(objectId.objectId);
+	canonical.append(directivesKey);
+	hash = std::hash<std::string> {}(canonical);
 }
 
-template <typename T, service::TypeModifier... Modifiers>
-int CompareDirectives(std::string_view directiveName, std::string_view argumentName,
-	const service::Directives& lhs, const service::Directives& rhs)
+template <class T>
+std::vector<std::shared_ptr<T>> Subscription::BackfillRows(
+	const RegistrationKey& key, TableSink<T>& sink) const
 {
-	const auto itrLhs =
-		std::find_if(lhs.begin(), lhs.end(), [directiveName](const auto& entry) noexcept {
-			return entry.first == directiveName;
-		});
-
-	const auto itrRhs =
-		std::find_if(rhs.begin(), rhs.end(), [directiveName](const auto& entry) noexcept {
-			return entry.first == directiveName;
-		});
-
-	if (itrLhs != lhs.end() || itrRhs != rhs.end())
+	if (sink.rows.empty())
 	{
-		if (itrLhs == lhs.end())
-		{
-			return -1;
-		}
-		else if (itrRhs == rhs.end())
-		{
-			return 1;
-		}
-
-		auto lhsArgument =
-			service::ModifiedArgument<T>::template find<Modifiers...>(argumentName, itrLhs->second);
-		auto rhsArgument =
-			service::ModifiedArgument<T>::template find<Modifiers...>(argumentName, itrRhs->second);
-
-		if (lhsArgument.second || rhsArgument.second)
-		{
-			if (!lhsArgument.second)
-			{
-				return -1;
-			}
-			else if (!rhsArgument.second)
-			{
-				return 1;
-			}
-
-			const auto& lhsValue = lhsArgument.first;
-			const auto& rhsValue = rhsArgument.first;
-
-			if (lhsValue < rhsValue)
-			{
-				return -1;
-			}
-			else if (rhsValue < lhsValue)
-			{
-				return 1;
-			}
-		}
+		// There's nothing left to seek from, so read the window from the start again.
+		sink.rows = LoadRows<T>(key, sink.store, sink.table);
+		sink.complete = sink.rows.size() < sink.take;
+		return sink.rows;
 	}
 
-	return 0;
-}
+	// The instance key of the last row in the window works as a bookmark for the edge of the
+	// window, which stays valid while other rows are added and removed around it.
+	const auto& lastKey = sink.rows.back()->instanceKey();
+	SPropValue prop {};
+	SRestriction restriction {};
 
-bool Subscription::RegistrationKey::operator<(const RegistrationKey& rhs) const noexcept
-{
-	if (objectId < rhs.objectId)
-	{
-		return true;
-	}
-	else if (rhs.objectId < objectId)
-	{
-		return false;
-	}
+	prop.ulPropTag = PR_INSTANCE_KEY;
+	prop.Value.bin.cb = static_cast<ULONG>(lastKey.size());
+	prop.Value.bin.lpb = const_cast<LPBYTE>(reinterpret_cast<const BYTE*>(lastKey.data()));
 
-	const int compareOffset =
-		CompareDirectives<int>("offset"sv, "count"sv, directives, rhs.directives);
+	restriction.rt = RES_PROPERTY;
+	restriction.res.resProperty.relop = RELOP_EQ;
+	restriction.res.resProperty.ulPropTag = prop.ulPropTag;
+	restriction.res.resProperty.lpProp = &prop;
 
-	if (compareOffset != 0)
+	if (FAILED(sink.table->FindRow(&restriction, BOOKMARK_BEGINNING, 0)))
 	{
-		return compareOffset < 0;
+		// The last row was deleted too, we'll try again when we get that notification.
+		return {};
 	}
 
-	const int compareTake = CompareDirectives<int>("take"sv, "count"sv, directives, rhs.directives);
+	const auto missing = sink.take - sink.rows.size();
+	rowset_ptr sprows;
 
-	if (compareTake != 0)
-	{
-		return compareTake < 0;
-	}
+	CORt(sink.table->SeekRow(BOOKMARK_CURRENT, 1, nullptr));
+	CORt(sink.table->QueryRows(static_cast<LONG>(missing), 0, &out_ptr { sprows }));
 
-	const int compareSeek =
-		CompareDirectives<response::IdType>("seek"sv, "id"sv, directives, rhs.directives);
+	std::vector<std::shared_ptr<T>> rows;
 
-	if (compareSeek != 0)
+	rows.reserve(static_cast<size_t>(sprows->cRows));
+	for (ULONG i = 0; i != sprows->cRows; i++)
 	{
-		return compareSeek < 0;
-	}
+		auto& row = sprows->aRow[i];
+		const size_t columnCount = static_cast<size_t>(row.cValues);
+		mapi_ptr<SPropValue> columns { row.lpProps };
 
-	const int compareColumns = CompareDirectives<Column, service::TypeModifier::List>("columns"sv,
-		"ids"sv,
-		directives,
-		rhs.directives);
+		row.lpProps = nullptr;
 
-	if (compareColumns != 0)
-	{
-		return compareColumns < 0;
+		rows.push_back(std::make_shared<T>(sink.store, nullptr, columnCount, std::move(columns)));
 	}
 
-	const int compareOrders = CompareDirectives<Order, service::TypeModifier::List>("orderBy"sv,
-		"sorts"sv,
-		directives,
-		rhs.directives);
-
-	if (compareOrders != 0)
-	{
-		return compareOrders < 0;
-	}
+	sink.rows.insert(sink.rows.end(), rows.begin(), rows.end());
+	sink.complete = rows.size() < missing;
 
-	return false;
+	return rows;
 }
 
-} // namespace graphql::mapi
\ No newline at end of file
+} // namespace graphql::mapi
@@ -36,8 +36,77 @@ std::optional<modified_type_t<T, Modifiers...>> GetFieldDirectiveArgument(
 		service::ModifiedArgument<T>::template require<Modifiers...>(argumentName, itr->second));
 }
 
+void AppendKeyInt(std::string& key, std::int64_t value)
+{
+	key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendKeyBytes(std::string& key, const void* data, size_t size)
+{
+	AppendKeyInt(key, static_cast<std::int64_t>(size));
+	key.append(reinterpret_cast<const char*>(data), size);
+}
+
+void AppendKeyPropId(std::string& key, const PropIdInput& property)
+{
+	if (property.id)
+	{
+		key.push_back('i');
+		AppendKeyInt(key, *property.id);
+		return;
+	}
+
+	CFRt(property.named);
+	CFRt(property.named->propset.type() == response::Type::String);
+
+	const auto propset = convert::guid::from_string(property.named->propset.get<std::string>());
+
+	key.push_back('n');
+	key.append(reinterpret_cast<const char*>(&propset), sizeof(propset));
+
+	if (property.named->id)
+	{
+		key.push_back('i');
+		AppendKeyInt(key, *property.named->id);
+	}
+	else
+	{
+		CFRt(property.named->name);
+		key.push_back('s');
+		AppendKeyBytes(key, property.named->name->data(), property.named->name->size());
+	}
+}
+
 } // namespace
 
+EntryIdRestriction::EntryIdRestriction(const std::vector<const response::IdType*>& ids)
+	: m_idProps(ids.size())
+	, m_idClauses(ids.size())
+{
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		auto& id = const_cast<response::IdType&>(*ids[i]);
+
+		m_idProps[i].ulPropTag = PR_ENTRYID;
+		m_idProps[i].Value.bin.cb = static_cast<ULONG>(id.size());
+		m_idProps[i].Value.bin.lpb = reinterpret_cast<LPBYTE>(id.data());
+
+		m_idClauses[i].rt = RES_PROPERTY;
+		m_idClauses[i].res.resProperty.relop = RELOP_EQ;
+		m_idClauses[i].res.resProperty.ulPropTag = PR_ENTRYID;
+		m_idClauses[i].res.resProperty.lpProp = &m_idProps[i];
+	}
+
+	m_restriction.rt = RES_OR;
+	m_restriction.res.resOr.cRes = static_cast<ULONG>(m_idClauses.size());
+	m_restriction.res.resOr.lpRes = m_idClauses.data();
+}
+
+LPSRestriction EntryIdRestriction::get() noexcept
+{
+	return &m_restriction;
+}
+
 TableDirectives::TableDirectives(
 	const std::shared_ptr<Store>& store, const service::Directives& fieldDirectives) noexcept
 	: m_store { store }
@@ -74,6 +143,66 @@ TableDirectives::TableDirectives(
 	}
 }
 
+std::string TableDirectives::canonicalKey() const
+{
+	// Tag each directive which was specified, and length-prefix anything variable, so two sets of
+	// directives only produce the same key if they are equivalent.
+	std::string key;
+
+	if (m_columns)
+	{
+		key.push_back('c');
+		AppendKeyInt(key, static_cast<std::int64_t>(m_columns->size()));
+
+		for (const auto& column : *m_columns)
+		{
+			AppendKeyInt(key, static_cast<std::int64_t>(column.type));
+			AppendKeyPropId(key, column.property);
+		}
+	}
+
+	if (m_orderBy)
+	{
+		key.push_back('o');
+		AppendKeyInt(key, static_cast<std::int64_t>(m_orderBy->size()));
+
+		for (const auto& order : *m_orderBy)
+		{
+			key.push_back(order.descending ? 'd' : 'a');
+			AppendKeyInt(key, static_cast<std::int64_t>(order.type));
+			AppendKeyPropId(key, order.property);
+		}
+	}
+
+	if (m_seek)
+	{
+		key.push_back('s');
+
+		if (*m_seek)
+		{
+			AppendKeyBytes(key, (*m_seek)->data(), (*m_seek)->size());
+		}
+		else
+		{
+			AppendKeyInt(key, -1);
+		}
+	}
+
+	if (m_offset)
+	{
+		key.push_back('f');
+		AppendKeyInt(key, *m_offset);
+	}
+
+	if (m_take)
+	{
+		key.push_back('t');
+		AppendKeyInt(key, *m_take);
+	}
+
+	return key;
+}
+
 rowset_ptr TableDirectives::read(IMAPITable* pTable, mapi_ptr<SPropTagArray>&& defaultColumns,
 	mapi_ptr<SSortOrderSet>&& defaultOrder) const
 {
@@ -103,6 +232,35 @@ rowset_ptr TableDirectives::read(IMAPITable* pTable, mapi_ptr<SPropTagArray>&& d
 	return result;
 }
 
+rowset_ptr TableDirectives::lookup(IMAPITable* pTable, mapi_ptr<SPropTagArray>&& defaultColumns,
+	const std::vector<response::IdType>& ids) const
+{
+	rowset_ptr result;
+	const auto properties = columns(std::move(defaultColumns));
+	std::vector<const response::IdType*> idPointers(ids.size());
+
+	std::transform(ids.cbegin(), ids.cend(), idPointers.begin(), [](const auto& id) noexcept {
+		return &id;
+	});
+
+	EntryIdRestriction restriction { idPointers };
+
+	CORt(pTable->SetColumns(properties.get(), TBL_BATCH));
+
+	// Don't batch the restriction, we need to know right away if the provider rejects it.
+	const HRESULT hrRestrict = pTable->Restrict(restriction.get(), 0);
+
+	if (hrRestrict == MAPI_E_NO_SUPPORT || hrRestrict == MAPI_E_TOO_COMPLEX)
+	{
+		return nullptr;
+	}
+
+	CORt(hrRestrict);
+	CORt(pTable->QueryRows(static_cast<LONG>(ids.size()), 0, &out_ptr { result }));
+
+	return result;
+}
+
 mapi_ptr<SPropTagArray> TableDirectives::columns(mapi_ptr<SPropTagArray>&& defaultColumns) const
 {
 	auto result = std::move(defaultColumns);
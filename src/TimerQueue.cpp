@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "Types.h"
+
+namespace graphql::mapi {
+
+TimerQueue::TimerQueue()
+	: m_state { std::make_shared<State>() }
+	, m_thread { [state = m_state]() {
+		// Flushing a coalesced batch delivers it, which resolves the payloads through MAPI.
+		const MAPIThreadScope scope;
+
+		Run(state);
+	} }
+{
+}
+
+TimerQueue::~TimerQueue()
+{
+	std::multimap<Clock::time_point, Callback> callbacks;
+
+	{
+		std::lock_guard lock { m_state->mutex };
+
+		m_state->stopped = true;
+		callbacks = std::move(m_state->callbacks);
+	}
+
+	m_state->condition.notify_all();
+
+	if (m_thread.get_id() == std::this_thread::get_id())
+	{
+		// One of our own callbacks released the last reference, the thread will exit as soon as
+		// it returns.
+		m_thread.detach();
+	}
+	else
+	{
+		m_thread.join();
+	}
+}
+
+void TimerQueue::schedule(Clock::time_point deadline, Callback&& callback)
+{
+	{
+		std::lock_guard lock { m_state->mutex };
+
+		m_state->callbacks.emplace(deadline, std::move(callback));
+	}
+
+	m_state->condition.notify_one();
+}
+
+void TimerQueue::Run(const std::shared_ptr<State>& state)
+{
+	std::unique_lock lock { state->mutex };
+
+	while (!state->stopped)
+	{
+		if (state->callbacks.empty())
+		{
+			state->condition.wait(lock);
+			continue;
+		}
+
+		const auto itr = state->callbacks.begin();
+
+		if (Clock::now() < itr->first)
+		{
+			state->condition.wait_until(lock, itr->first);
+			continue;
+		}
+
+		{
+			// Release the callback before re-acquiring the lock, it might hold the last reference
+			// to the TimerQueue.
+			auto callback = std::move(itr->second);
+
+			state->callbacks.erase(itr);
+			lock.unlock();
+
+			try
+			{
+				callback();
+			}
+			catch (const std::exception&)
+			{
+				// CORt and CFRt already reported the error, keep running the other callbacks.
+			}
+		}
+
+		lock.lock();
+	}
+}
+
+} // namespace graphql::mapi
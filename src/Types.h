@@ -6,6 +6,7 @@
 #define NOMINMAX
 
 #include "MAPISchema.h"
+#include "ServiceOptions.h"
 
 #include <windows.h>
 
@@ -29,13 +30,24 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
 #include <functional>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 
 #include "CheckResult.h"
+#include "ConcurrentCache.h"
 #include "Unicode.h"
 
 namespace graphql::mapi {
@@ -103,10 +115,30 @@ public:
 	explicit Session(bool useDefaultProfile);
 	~Session();
 
+	// Services which use the default profile share a single logon.
+	static std::shared_ptr<Session> logon(bool useDefaultProfile);
+
 	const CComPtr<IMAPISession>& session() const;
 
+	// Name of the profile we logged on to, or empty if MAPI didn't tell us.
+	const std::string& profile() const;
+
 private:
 	CComPtr<IMAPISession> m_session;
+	std::string m_profile;
+};
+
+// Each background thread which calls into MAPI needs to initialize it first.
+class MAPIThreadScope
+{
+public:
+	MAPIThreadScope() noexcept;
+	~MAPIThreadScope();
+
+	explicit operator bool() const noexcept;
+
+private:
+	const HRESULT m_result;
 };
 
 // Notification sink which will forward to a callback.
@@ -190,6 +222,204 @@ private:
 	std::atomic<ULONG> m_refcount { 1 };
 };
 
+// Background thread which invokes callbacks after a deadline.
+class TimerQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Callback = std::function<void()>;
+
+	TimerQueue();
+	~TimerQueue();
+
+	void schedule(Clock::time_point deadline, Callback&& callback);
+
+private:
+	// Shared with the thread so it can outlive the TimerQueue if one of the callbacks releases the
+	// last reference to it.
+	struct State
+	{
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::multimap<Clock::time_point, Callback> callbacks;
+		bool stopped = false;
+	};
+
+	static void Run(const std::shared_ptr<State>& state);
+
+	const std::shared_ptr<State> m_state;
+	std::thread m_thread;
+};
+
+// Bounded queue of notification batches which are translated and delivered on a pool of worker
+// threads. Work with the same key never runs concurrently or out of order.
+class NotificationQueue
+{
+public:
+	using Key = const void*;
+	using Callback = std::function<void()>;
+
+	explicit NotificationQueue(const SubscriptionOptions& options);
+	~NotificationQueue();
+
+	// Queue a batch of notifications. If the queue is full, this either waits for room or drops
+	// the batch and queues the reload callback in its place, depending on the QueueFullPolicy.
+	void push(Key key, Callback&& callback, Callback&& reload);
+
+	// Queue work which replaces pending notifications, so it ignores the capacity.
+	void post(Key key, Callback&& callback);
+
+private:
+	struct Work
+	{
+		Key key;
+		Callback callback;
+		bool batch = false;
+		bool reload = false;
+	};
+
+	// Shared with the threads so they can outlive the NotificationQueue if one of the callbacks
+	// releases the last reference to it.
+	struct State
+	{
+		size_t capacity = 0;
+		QueueFullPolicy policy = QueueFullPolicy::DropToReload;
+		std::shared_ptr<NotificationQueueMetrics> metrics;
+
+		std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::condition_variable roomAvailable;
+		std::deque<Work> queue;
+		size_t batches = 0;
+		std::set<Key> busy;
+		std::set<Key> reloads;
+		bool stopped = false;
+	};
+
+	static void Run(const std::shared_ptr<State>& state);
+	static void UpdateDepth(State& state) noexcept;
+
+	const std::shared_ptr<State> m_state;
+	std::vector<std::thread> m_threads;
+};
+
+// Runs the MAPI work for each store on a pool of worker threads. Work for the same store runs one
+// at a time and in order, but different stores resolve concurrently.
+class StoreExecutor
+{
+public:
+	using Key = const void*;
+	using Work = std::function<void()>;
+
+	explicit StoreExecutor(const ExecutorOptions& options);
+	~StoreExecutor();
+
+	// Resolvers co_await this to resume on a worker thread, behind any other work for the same
+	// key. If this thread is already running work for the same key, or there are no worker
+	// threads, the coroutine keeps going without suspending.
+	class Awaitable
+	{
+	public:
+		bool await_ready() const noexcept;
+		void await_suspend(std::coroutine_handle<> handle);
+		void await_resume() const noexcept;
+
+	private:
+		friend class StoreExecutor;
+
+		Awaitable(StoreExecutor& executor, Key key) noexcept;
+
+		StoreExecutor& m_executor;
+		const Key m_key;
+	};
+
+	Awaitable schedule(Key key) noexcept;
+
+private:
+	// Shared with the threads so they can outlive the StoreExecutor if some work releases the last
+	// reference to it.
+	struct State
+	{
+		std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::deque<std::pair<Key, Work>> queue;
+		std::set<Key> busy;
+		bool stopped = false;
+	};
+
+	void post(Key key, Work&& work);
+	static void Run(const std::shared_ptr<State>& state);
+
+	const std::shared_ptr<State> m_state;
+	std::vector<std::thread> m_threads;
+};
+
+// Single IMsgStore::Advise connection for object events in a store, which fans them out to the
+// listeners registered on the parent folder of each object, or on the object itself.
+class ObjectNotificationDispatcher
+{
+public:
+	using Callback = std::function<void(const NOTIFICATION&)>;
+
+	struct Listener
+	{
+		ULONG objectType;
+		Callback callback;
+	};
+
+	explicit ObjectNotificationDispatcher(IMsgStore* store);
+	~ObjectNotificationDispatcher();
+
+	// Number of notifications for any object in the store, so callers can tell if anything in it
+	// changed since they last looked.
+	size_t version() const noexcept;
+
+	// Listen for events on objects of this type (MAPI_FOLDER or MAPI_MESSAGE) in the parent
+	// folder. The listener is removed when the caller releases the result.
+	std::shared_ptr<Listener> subscribe(
+		const response::IdType& parentId, ULONG objectType, Callback&& callback);
+
+	// Listen for fnevObjectModified events on the object itself, e.g. when the counts on a folder
+	// change. The listener is removed when the caller releases the result.
+	std::shared_ptr<Listener> watch(
+		const response::IdType& entryId, ULONG objectType, Callback&& callback);
+
+private:
+	using ListenerMap = std::multimap<response::IdType, std::weak_ptr<Listener>>;
+
+	// The listeners are keyed by their normalized entry IDs. Notifications may still use a form of
+	// an entry ID which doesn't match those bytes, so remember which ones the store matched to a
+	// listener's ID, and how many of the keys (in the order they were added) each of the others
+	// was already compared with.
+	struct ListenerIndex
+	{
+		ListenerMap map;
+		std::vector<response::IdType> keys;
+		std::map<response::IdType, response::IdType> aliases;
+		std::map<response::IdType, size_t> unmatched;
+	};
+
+	// Shared with the advise sink, which may still be running on a MAPI thread.
+	struct State
+	{
+		CComPtr<IMsgStore> store;
+		std::mutex mutex;
+		ListenerIndex listeners;
+		ListenerIndex watchers;
+		std::atomic<size_t> version { 0 };
+	};
+
+	std::shared_ptr<Listener> Add(
+		ListenerIndex& index, const response::IdType& id, ULONG objectType, Callback&& callback);
+
+	static void Dispatch(State& state, const NOTIFICATION& notif);
+	static void Collect(State& state, ListenerIndex& index, const response::IdType& id,
+		ULONG objectType, std::vector<std::shared_ptr<Listener>>& listeners);
+
+	const std::shared_ptr<State> m_state;
+	CComPtr<AdviseSinkProxy<IMsgStore>> m_sinkProxy;
+};
+
 // Additional property tags which MAPIStubLibrary doesn't know about.
 constexpr ULONG PR_CONVERSATION_ID = PROP_TAG(PT_BINARY,
 	0x3013); // https://docs.microsoft.com/en-us/openspecs/exchange_server_protocols/ms-oxprops/7fdd0560-5e41-4518-bfbb-0c5a6eb6be6c
@@ -199,39 +429,164 @@ class Store;
 class Folder;
 class Item;
 class Property;
+class TableDirectives;
+
+// Hash entry IDs by their bytes to pick a cache shard.
+struct EntryIdHash
+{
+	size_t operator()(const response::IdType& id) const noexcept
+	{
+		return std::hash<std::string_view> {}(
+			{ reinterpret_cast<const char*>(id.data()), id.size() });
+	}
+};
+
+using StoreSnapshot = TableSnapshot<response::IdType, Store>;
+using FolderSnapshot = TableSnapshot<response::IdType, Folder>;
+using ItemSnapshot = TableSnapshot<response::IdType, Item>;
+
+class Query;
+
+// Stores which every service in the process shares, keyed by profile and store entry ID, so each
+// service doesn't keep its own copy of the folder and item caches and advise on the same store
+// again. It only holds weak references, and the stores are released with the last service which
+// uses them.
+class SharedStores
+{
+public:
+	static SharedStores& instance();
+
+	// Return the store which is already shared for the same profile and entry ID if it read the
+	// same columns from the message stores table, otherwise share this one instead. The shared
+	// store keeps the session, options, and executor it was created with.
+	std::shared_ptr<Store> share(const std::string& profile, std::shared_ptr<Store>&& store,
+		const std::shared_ptr<const Query>& owner);
+
+	// Check if this service owns the store and may clear its caches at the end of each query. The
+	// service which shared it first owns it, until that service is released and another one asks.
+	bool owns(const std::string& profile, const Store& store,
+		const std::shared_ptr<const Query>& query);
+
+private:
+	using Key = std::pair<std::string, response::IdType>;
+
+	struct Entry
+	{
+		std::weak_ptr<Store> store;
+		std::weak_ptr<const Query> owner;
+	};
+
+	std::mutex m_mutex;
+	std::map<Key, Entry> m_stores;
+};
+
+// Versions of the stores table and of each store which a response read. A store's version is
+// std::nullopt if nothing was listening for its notifications, so it can't tell if it changed.
+struct ResponseVersions
+{
+	size_t query = 0;
+	std::vector<std::pair<std::weak_ptr<Store>, std::optional<size_t>>> stores;
+};
+
+// Serialized responses to queries, keyed by the query text, operation name and variables, which
+// also determine the directives. They're only returned while none of the versions they read have
+// moved, so a repeated query doesn't need to touch MAPI.
+class ResponseCache
+{
+public:
+	explicit ResponseCache(const ResponseCacheOptions& options);
+
+	std::string resolve(Query& query, service::Request& request, std::string_view queryText,
+		std::string_view operationName, const response::Value& variables);
+
+	// Responses can only be cached if everything they read is versioned by the stores table or a
+	// store. msgFileData reads a file, so any document which selects it is never cached.
+	static bool ReadsOnlyStores(const peg::ast& ast);
+
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string json;
+		ResponseVersions versions;
+	};
+
+	using EntryList = std::list<Entry>;
+
+	std::optional<std::string> Find(Query& query, const std::string& key);
+	void Insert(std::string&& key, const std::string& json, ResponseVersions&& versions);
+
+	const size_t m_capacity;
+	const std::shared_ptr<ResponseCacheMetrics> m_metrics;
+
+	std::mutex m_mutex;
+
+	// The most recently used entries are at the front.
+	EntryList m_entries;
+	std::unordered_map<std::string_view, EntryList::iterator> m_keys;
+};
 
 class Query : public std::enable_shared_from_this<Query>
 {
 public:
-	explicit Query(const std::shared_ptr<Session>& session);
+	explicit Query(const std::shared_ptr<Session>& session, const ServiceOptions& options);
 	~Query();
 
 	// Accessors used by other MAPIGraphQL classes
-	const std::vector<std::shared_ptr<Store>>& stores();
+	std::shared_ptr<const std::vector<std::shared_ptr<Store>>> stores();
 	std::shared_ptr<Store> lookup(const response::IdType& id);
 
-	// Clear cached folders and items in all stores.
+	// Start loading the stores on a background thread. The accessors and resolvers wait for it.
+	void warmUp(WarmUpPolicy policy);
+
+	// Clear cached folders and items in all stores, including the ones other services share.
 	void ClearCaches();
 
-	// Clear the folder and item caches at the end of the selection set.
+	// Clear the folder and item caches at the end of the selection set, in the stores which this
+	// service owns.
 	void endSelectionSet(const service::SelectionSetParams& params);
 
+	// Response cache for ResolveToJSON, or nullptr if ServiceOptions didn't enable it.
+	const std::shared_ptr<ResponseCache>& responses() const noexcept;
+
+	// Capture the versions before resolving a query, then check that none of them moved after
+	// resolving it. That returns the versions of the stores it opened, or std::nullopt if it
+	// can't be cached. A cached response is current as long as those versions don't move.
+	ResponseVersions captureVersions() const;
+	std::optional<ResponseVersions> verifyVersions(const ResponseVersions& before) const;
+	bool isCurrent(const ResponseVersions& versions) const;
+
+	// Mutations move the version of every cached response.
+	void invalidateResponses() noexcept;
+
 	// Resolvers/Accessors which implement the GraphQL type
-	std::vector<std::shared_ptr<object::Store>> getStores(
-		service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Store>>> getStores(
+		service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg);
 	std::vector<std::shared_ptr<object::Property>> getMsgFileData(
 		service::FieldParams&& params, std::string&& filepathArg, std::vector<Column>&& propsArg);
 
 private:
 	std::shared_ptr<Session> m_session;
+	const HierarchyOptions m_hierarchyOptions;
+	const TableCacheOptions m_tableOptions;
+	const std::shared_ptr<StoreExecutor> m_executor;
 
 	// These lazy load and cache results between calls to const methods.
-	void LoadStores(service::Directives&& fieldDirectives);
+	std::shared_ptr<const StoreSnapshot> LoadStores(const service::Directives& fieldDirectives);
+	void ReadStores(const TableDirectives& directives, StoreSnapshot& snapshot);
 
-	std::unique_ptr<std::map<response::IdType, size_t>> m_ids;
-	std::unique_ptr<std::vector<std::shared_ptr<Store>>> m_stores;
+	// WarmUp runs on the warm-up thread, everything else waits for it to finish first.
+	void WarmUp(WarmUpPolicy policy);
+	void WaitForWarmUp() const;
+
+	std::thread m_warmUpThread;
+	std::shared_future<void> m_warmUp;
+
+	SnapshotTable<response::IdType, Store, std::string> m_stores;
 	CComPtr<AdviseSinkProxy<IMAPITable>> m_storeSink;
-	service::Directives m_storeDirectives;
+
+	const std::shared_ptr<ResponseCache> m_responses;
+	std::atomic<size_t> m_responseVersion { 0 };
 };
 
 class Mutation
@@ -243,7 +598,8 @@ public:
 	// Accessors used by other MAPIGraphQL classes
 	bool CopyItems(MultipleItemsInput&& inputArg, ObjectId&& destinationArg, bool moveItems);
 
-	// Clear the folder and item caches at the end of the selection set.
+	// Clear the folder and item caches at the end of the selection set, in the stores which this
+	// service owns.
 	void endSelectionSet(const service::SelectionSetParams& params);
 
 	// Resolvers/Accessors which implement the GraphQL type
@@ -264,7 +620,7 @@ private:
 class Subscription : public std::enable_shared_from_this<Subscription>
 {
 public:
-	explicit Subscription(const std::shared_ptr<Query>& query);
+	explicit Subscription(const std::shared_ptr<Query>& query, const SubscriptionOptions& options);
 	~Subscription();
 
 	void setService(const std::shared_ptr<Operations>& service) noexcept;
@@ -276,24 +632,88 @@ public:
 		service::FieldParams&& params, ObjectId&& parentFolderIdArg);
 	std::vector<std::shared_ptr<object::FolderChange>> getRootFolders(
 		service::FieldParams&& params, response::IdType&& storeIdArg);
+	std::vector<std::shared_ptr<object::FolderCounts>> getFolderCounts(
+		service::FieldParams&& params, std::vector<ObjectId>&& folderIdsArg);
+
+	// The @resume directive is handled by the Subscription and the payloads instead of the
+	// TableDirectives, so subscribers which resume from different sequences share a sink.
+	static std::optional<int> TakeResumeDirective(service::Directives& fieldDirectives);
+	static std::optional<int> GetResumeDirective(const service::Directives& fieldDirectives);
 
 private:
 	// These are all initialized at construction.
 	std::shared_ptr<Query> m_query;
+	const SubscriptionOptions m_options;
+
+	// Changes on every sink are numbered from the same counter, so a sequence from another sink
+	// or an earlier registration never looks like a recent one. It wraps from the largest Int back
+	// to 1 instead of going negative.
+	mutable std::atomic<int> m_sequence { 0 };
+
+	// Only created if notifications are coalesced, or when the first folderCounts subscriber
+	// registers if they are rate limited. Flushes each sink when its window closes.
+	mutable std::unique_ptr<TimerQueue> m_timerQueue;
+
+	// Only created if there are dispatch threads, otherwise the notifications are handled on the
+	// MAPI notification thread.
+	std::unique_ptr<NotificationQueue> m_notificationQueue;
 
 	// Initialized after construction with setService.
 	std::weak_ptr<Operations> m_service;
 
 	struct RegistrationKey
 	{
+		explicit RegistrationKey(ObjectId&& objectIdArg, service::Directives&& directivesArg);
+
 		// These form the key in each set of registrations.
 		ObjectId objectId;
 		service::Directives directives;
 
-		// Enable < comparisons so it can be used a std::multiset.
-		bool operator<(const RegistrationKey& rhs) const noexcept;
+		// Canonical encoding of the objectId and table directives, and its hash, which are
+		// computed once at registration.
+		std::string canonical;
+		size_t hash;
+
+		bool operator==(const RegistrationKey& rhs) const noexcept
+		{
+			return hash == rhs.hash && canonical == rhs.canonical;
+		}
+
+		struct Hash
+		{
+			size_t operator()(const RegistrationKey& key) const noexcept
+			{
+				return key.hash;
+			}
+		};
+	};
+
+	// Copy of a table notification which can outlive the call to IMAPIAdviseSink::OnNotify.
+	struct TableNotification
+	{
+		explicit TableNotification(ULONG event) noexcept;
+		explicit TableNotification(const TABLE_NOTIFICATION& notif);
+
+		ULONG tableEvent = 0;
+
+		// PR_INSTANCE_KEY of the row from propIndex, and of the row before it from propPrior.
+		std::optional<response::IdType> indexKey;
+		std::optional<response::IdType> priorKey;
+
+		// The row was added at the beginning of the table, propPrior was PR_NULL.
+		bool addedFirst = false;
+
+		// Columns of an added or modified row.
+		size_t columnCount = 0;
+		mapi_ptr<SPropValue> columns;
+
+	private:
+		static std::optional<response::IdType> CopyInstanceKey(const SPropValue& prop);
 	};
 
+	// Run the callback on the notification queue, or right away if there isn't one.
+	void Post(const void* key, std::function<void()>&& callback) const;
+
 	// If multiple subscriptions are registered with the same arguments and directives, they
 	// should re-use the existing sink.
 	template <class Row>
@@ -311,27 +731,78 @@ private:
 
 		// Cache the window of rows to use for translating the table notifications.
 		std::vector<std::shared_ptr<Row>> rows;
+
+		// Notifications may arrive on any MAPI thread, and coalesced changes are flushed from the
+		// TimerQueue thread.
+		std::mutex mutex;
+
+		// While notifications are being coalesced, this holds the window the listeners last saw.
+		std::optional<std::vector<std::shared_ptr<Row>>> pendingBaseline;
+		size_t pendingCount = 0;
+		size_t pendingWindow = 0;
+		bool pendingReload = false;
+
+		// Number of rows in a full window, or 0 if it reads backwards and can't be backfilled.
+		size_t take = 0;
+
+		// The last read reached the end of the table, so there's nothing left to backfill.
+		bool complete = false;
+
+		// Sequence of the last change, the batches which were delivered after evicted, and the
+		// number of changes in them.
+		using Change = std::conditional_t<std::is_same_v<Row, Item>, object::ItemChange,
+			object::FolderChange>;
+
+		int sequence = 0;
+		int evicted = 0;
+		std::deque<std::pair<int, std::vector<std::shared_ptr<Change>>>> history;
+		size_t historySize = 0;
+
+		// Subscribers which @resume from each sequence, and whether they're still waiting for the
+		// replay, which delivers the changes after that sequence.
+		struct Resume
+		{
+			size_t subscribers = 0;
+			bool pending = false;
+		};
+
+		std::map<int, Resume> resumes;
+		std::function<void(int)> replay;
+
+		// The last subscriber left, and the sink is only retained for @resume.
+		bool retired = false;
 	};
 
 	// Track the registration of listeners for a given table and set of table directives.
+	// Registrations which are retained for @resume, with the one which has been idle the longest
+	// first. The keys in an unordered_map stay put when it rehashes.
+	using IdleRegistrations = std::list<const RegistrationKey*>;
+
 	template <class Row>
 	struct Registration
 	{
-		const RegistrationKey key;
-
-		// Enable < comparisons so it can be used a std::multiset.
-		bool operator<(const Registration& rhs) const noexcept
-		{
-			return key < rhs.key;
-		}
-
 		std::shared_ptr<TableSink<Row>> sink;
+		size_t subscribers = 0;
+
+		// Set while the registration is retained for @resume after the last subscriber left.
+		std::optional<IdleRegistrations::iterator> idle;
 	};
 
+	template <class Row>
+	using Registrations =
+		std::unordered_map<RegistrationKey, Registration<Row>, RegistrationKey::Hash>;
+
 	template <class T, class ArgumentType, class PayloadType>
 	void RegisterAdviseSinkProxy(service::await_async launch, std::string&& fieldName,
 		std::string_view argumentName, const ArgumentType& argumentValue,
-		Registration<T>& registration) const;
+		const RegistrationKey& key, Registration<T>& registration) const;
+
+	template <class T>
+	void AddSubscriber(IdleRegistrations& idle, Registration<T>& registration,
+		std::optional<int> resume) const;
+	template <class T>
+	void RemoveSubscriber(Registrations<T>& registrations, IdleRegistrations& idle,
+		typename Registrations<T>::iterator itr, std::optional<int> resume) const;
 
 	template <class T>
 	std::vector<std::shared_ptr<T>> LoadRows(const RegistrationKey& key,
@@ -345,12 +816,68 @@ private:
 	std::vector<std::shared_ptr<Folder>> LoadRows<Folder>(const RegistrationKey& key,
 		std::shared_ptr<Store>& store, CComPtr<IMAPITable>& spTable) const;
 
-	// Using std::multiset because there could be multiple subscriptions on the same
-	// ObjectId and table directives. In that case, they should all take a reference on
-	// the same Registration::sink member and share a single IMAPIAdviseSink registration.
-	mutable std::multiset<Registration<Item>> m_itemSinks;
-	mutable std::multiset<Registration<Folder>> m_subFolderSinks;
-	mutable std::multiset<Registration<Folder>> m_rootFolderSinks;
+	// Read the rows which follow the end of the window until it's full again.
+	template <class T>
+	std::vector<std::shared_ptr<T>> BackfillRows(
+		const RegistrationKey& key, TableSink<T>& sink) const;
+
+	// There could be multiple subscriptions on the same ObjectId and table directives. In that
+	// case, they should all share the same Registration::sink member and a single
+	// IMAPIAdviseSink registration, which is released when the last one unsubscribes.
+	mutable Registrations<Item> m_itemSinks;
+	mutable Registrations<Folder> m_subFolderSinks;
+	mutable Registrations<Folder> m_rootFolderSinks;
+	mutable IdleRegistrations m_idleItemSinks;
+	mutable IdleRegistrations m_idleSubFolderSinks;
+	mutable IdleRegistrations m_idleRootFolderSinks;
+
+	// The folderCounts subscriptions only need the object notifications on each folder instead of
+	// a table window, and every subscriber which includes the same folder shares one listener.
+	struct CountsSink
+	{
+		std::shared_ptr<Folder> folder;
+		std::shared_ptr<ObjectNotificationDispatcher::Listener> listener;
+
+		// Notifications arrive on MAPI threads, and rate limited reads run on the TimerQueue.
+		std::mutex mutex;
+
+		// The counts the listeners last saw, when they can see the next ones, and whether a read
+		// is already on the way.
+		int count = 0;
+		int unread = 0;
+		TimerQueue::Clock::time_point nextRead {};
+		bool scheduled = false;
+	};
+
+	struct CountsRegistration
+	{
+		std::shared_ptr<CountsSink> sink;
+		size_t subscribers = 0;
+	};
+
+	void RegisterCountsListener(service::await_async launch, const RegistrationKey& key,
+		CountsRegistration& registration) const;
+
+	mutable std::unordered_map<RegistrationKey, CountsRegistration, RegistrationKey::Hash>
+		m_countSinks;
+};
+
+// RES_OR of PR_ENTRYID equality clauses, which matches the rows with any of the entry IDs. It
+// points at the IDs, so they need to outlive it.
+class EntryIdRestriction
+{
+public:
+	explicit EntryIdRestriction(const std::vector<const response::IdType*>& ids);
+
+	EntryIdRestriction(const EntryIdRestriction&) = delete;
+	EntryIdRestriction& operator=(const EntryIdRestriction&) = delete;
+
+	LPSRestriction get() noexcept;
+
+private:
+	std::vector<SPropValue> m_idProps;
+	std::vector<SRestriction> m_idClauses;
+	SRestriction m_restriction {};
 };
 
 class TableDirectives
@@ -362,13 +889,24 @@ public:
 	rowset_ptr read(IMAPITable* pTable, mapi_ptr<SPropTagArray>&& defaultColumns,
 		mapi_ptr<SSortOrderSet>&& defaultOrder = {}) const;
 
+	// Read only the rows with the requested entry IDs, with the same columns as read. The paging
+	// and sorting directives don't apply. Returns nullptr if the provider can't restrict the table
+	// that way.
+	rowset_ptr lookup(IMAPITable* pTable, mapi_ptr<SPropTagArray>&& defaultColumns,
+		const std::vector<response::IdType>& ids) const;
+
+	// Compact byte string which compares equal for equivalent directives.
+	std::string canonicalKey() const;
+
+	// Number of rows to read, negative numbers read backwards from the seek position.
+	LONG take() const;
+
 private:
 	mapi_ptr<SPropTagArray> columns(mapi_ptr<SPropTagArray>&& defaultColumns) const;
 	mapi_ptr<SSortOrderSet> orderBy(mapi_ptr<SSortOrderSet>&& defaultOrder) const;
 	mapi_ptr<SRestriction> seek() const;
 	BOOKMARK seekBookmark() const;
 	LONG offset() const;
-	LONG take() const;
 
 	const std::shared_ptr<Store> m_store;
 	const std::optional<std::vector<Column>> m_columns;
@@ -389,8 +927,9 @@ using NameIdToPropId = std::map<mapi_ptr<MAPINAMEID>, ULONG, CompareMAPINAMEID>;
 class Store : public std::enable_shared_from_this<Store>
 {
 public:
-	explicit Store(
-		const CComPtr<IMAPISession>& session, size_t columnCount, mapi_ptr<SPropValue>&& columns);
+	explicit Store(const CComPtr<IMAPISession>& session, size_t columnCount,
+		mapi_ptr<SPropValue>&& columns, const HierarchyOptions& hierarchyOptions,
+		const TableCacheOptions& tableOptions, const std::shared_ptr<StoreExecutor>& executor);
 	~Store();
 
 	// Accessors used by other MAPIGraphQL classes
@@ -417,9 +956,21 @@ public:
 	}
 
 	const CComPtr<IMsgStore>& store();
+	const std::shared_ptr<ObjectNotificationDispatcher>& notifications();
+
+	// These don't open the store. The version is std::nullopt until something listens for its
+	// notifications.
+	bool opened();
+	std::optional<size_t> version();
+
+	// Compare the columns which were read from the message stores table.
+	bool sameColumns(const Store& other) const;
+
+	const std::shared_ptr<StoreExecutor>& executor() const;
+	const TableCacheOptions& tableOptions() const;
 	const response::IdType& id() const;
 	const response::IdType& rootId() const;
-	const std::vector<std::shared_ptr<Folder>>& rootFolders();
+	std::shared_ptr<const std::vector<std::shared_ptr<Folder>>> rootFolders();
 	std::shared_ptr<Folder> lookupRootFolder(const response::IdType& id);
 	const std::map<SpecialFolder, response::IdType>& specialFolders();
 	std::shared_ptr<Folder> lookupSpecialFolder(SpecialFolder id);
@@ -434,28 +985,119 @@ public:
 		IMAPIProp* pObject, std::optional<std::vector<Column>>&& idsArg);
 	void ConvertPropertyInputs(void* pAllocMore, LPSPropValue propBegin, LPSPropValue propEnd,
 		std::vector<PropertyInput>&& input);
+	mapi_ptr<SPropTagArray> GetFolderProperties() const;
+	mapi_ptr<SPropTagArray> GetItemProperties() const;
+
+	// Tables might return a different form of the same entry ID than the one we asked for.
+	bool CompareEntryIds(const response::IdType& lhs, const response::IdType& rhs);
+
+	// Put the objects which were read for the requested entry IDs in the order they were
+	// requested, leaving out any which weren't found. They're matched by their bytes first, and
+	// only the IDs and objects which are left over are compared with the store.
+	template <class Object>
+	std::vector<std::shared_ptr<Object>> MatchEntryIds(const std::vector<response::IdType>& ids,
+		const std::vector<std::shared_ptr<Object>>& objects)
+	{
+		// Each object, and whether one of the IDs matched it exactly.
+		std::unordered_map<response::IdType, std::pair<std::shared_ptr<Object>, bool>, EntryIdHash>
+			exactIds;
+
+		exactIds.reserve(objects.size());
+		for (const auto& object : objects)
+		{
+			exactIds.emplace(object->id(), std::make_pair(object, false));
+		}
+
+		std::vector<std::shared_ptr<Object>> matches(ids.size());
+
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			if (const auto itr = exactIds.find(ids[i]); itr != exactIds.end())
+			{
+				matches[i] = itr->second.first;
+				itr->second.second = true;
+			}
+		}
+
+		std::vector<std::shared_ptr<Object>> leftover;
+
+		for (const auto& [id, entry] : exactIds)
+		{
+			if (!entry.second)
+			{
+				leftover.push_back(entry.first);
+			}
+		}
+
+		std::vector<std::shared_ptr<Object>> result;
 
-	// Open and cache folders and items
+		result.reserve(ids.size());
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			if (!matches[i])
+			{
+				const auto itr = std::find_if(leftover.cbegin(),
+					leftover.cend(),
+					[this, &id = ids[i]](const std::shared_ptr<Object>& object) {
+						return CompareEntryIds(id, object->id());
+					});
+
+				if (itr == leftover.cend())
+				{
+					continue;
+				}
+
+				matches[i] = *itr;
+			}
+
+			result.push_back(std::move(matches[i]));
+		}
+
+		return result;
+	}
+
+	// Open and cache folders and items. If another thread already cached the same folder or item,
+	// CacheFolder and CacheItem return that one instead.
 	std::shared_ptr<Folder> OpenFolder(const response::IdType& folderId);
 	std::shared_ptr<Item> OpenItem(const response::IdType& itemId);
-	void CacheFolder(const std::shared_ptr<Folder>& folder);
-	void CacheItem(const std::shared_ptr<Item>& item);
+	std::shared_ptr<Folder> CacheFolder(const std::shared_ptr<Folder>& folder);
+	std::shared_ptr<Item> CacheItem(const std::shared_ptr<Item>& item);
 	void ClearCaches();
 
+	// Resolvers queue the folders they need before they wait for the executor, and whichever one
+	// runs first opens everything which was queued by then together. This only batches resolvers
+	// which queued their folders while another one was waiting for a worker thread, without any
+	// worker threads each of them just opens its own folder.
+	void QueueFolder(const response::IdType& folderId);
+	void OpenQueuedFolders();
+
+	// Properties for each object in a batch, or std::nullopt if it couldn't be read.
+	using BatchProperties =
+		std::vector<std::optional<std::vector<std::shared_ptr<object::Property>>>>;
+
 	// Resolvers/Accessors which implement the GraphQL type
 	const response::IdType& getId() const;
 	const std::string& getName() const;
 	std::vector<std::shared_ptr<object::Property>> getColumns();
-	std::vector<std::shared_ptr<object::Folder>> getRootFolders(
-		service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg);
-	std::vector<std::shared_ptr<object::Folder>> getSpecialFolders(
-		std::vector<SpecialFolder>&& idsArg);
-	std::vector<std::shared_ptr<object::Property>> getFolderProperties(
-		response::IdType&& folderIdArg, std::optional<std::vector<Column>>&& idsArg);
-	std::vector<std::shared_ptr<object::Property>> getItemProperties(
-		response::IdType&& itemIdArg, std::optional<std::vector<Column>>&& idsArg);
-    std::optional<std::vector<std::shared_ptr<object::Folder>>> getFolderHierarchy(
-        std::optional<response::IdType> parentFolderIdArg, response::BooleanType&& onlyChildrenArg);
+	// The resolvers which call into MAPI are coroutines which resume on the StoreExecutor. They
+	// take their arguments by value, because the generated resolvers don't keep them alive.
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> getRootFolders(
+		service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> getSpecialFolders(
+		std::vector<SpecialFolder> idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Property>>> getFolderProperties(
+		response::IdType folderIdArg, std::optional<std::vector<Column>> idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Property>>> getItemProperties(
+		response::IdType itemIdArg, std::optional<std::vector<Column>> idsArg);
+	service::AwaitableObject<BatchProperties> getFoldersProperties(
+		std::vector<response::IdType> folderIdsArg, std::optional<std::vector<Column>> idsArg);
+	service::AwaitableObject<BatchProperties> getItemsProperties(
+		std::optional<response::IdType> folderIdArg, std::vector<response::IdType> itemIdsArg,
+		std::optional<std::vector<Column>> idsArg);
+	service::AwaitableObject<std::optional<std::vector<std::shared_ptr<object::Folder>>>>
+	getFolderHierarchy(std::optional<response::IdType> parentFolderIdArg,
+		response::BooleanType onlyChildrenArg, std::optional<int> maxDepthArg,
+		std::optional<std::vector<std::string>> containerClassesArg);
 
 private:
 	// Used during construction
@@ -469,19 +1111,59 @@ private:
 	const mapi_ptr<SPropValue> m_columns;
 	const response::IdType m_id;
 	const std::string m_name;
+	const HierarchyOptions m_hierarchyOptions;
+	const TableCacheOptions m_tableOptions;
+	const std::shared_ptr<StoreExecutor> m_executor;
 
-	// These lazy load and cache results between calls to const methods.
+	// These lazy load and cache results between calls to const methods. Root folders only need the
+	// IPM Subtree, the special folders also need the Inbox.
 	void OpenStore();
+	void OpenIPMSubtree();
+	void LoadInbox();
 	void LoadSpecialFolders();
-	void LoadRootFolders(service::Directives&& fieldDirectives);
-	mapi_ptr<SPropTagArray> GetFolderProperties() const;
-	mapi_ptr<SPropTagArray> GetItemProperties() const;
+	std::shared_ptr<const FolderSnapshot> LoadRootFolders(
+		const service::Directives& fieldDirectives);
+	void ReadRootFolders(const TableDirectives& directives, FolderSnapshot& snapshot);
+	std::vector<std::shared_ptr<Folder>> LookupRootFolders(
+		const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids);
+
+	// Read the folder hierarchy below the ancestor in pre-order, either from a single
+	// CONVENIENT_DEPTH hierarchy table, or by walking one hierarchy table per folder on a pool of
+	// threads if the provider doesn't support that.
+	std::optional<std::vector<std::shared_ptr<Folder>>> ReadFolderHierarchy(IMAPIFolder* pAncestor,
+		std::optional<int> maxDepth,
+		const std::optional<std::vector<std::string>>& containerClasses);
+	std::vector<std::shared_ptr<Folder>> WalkFolderHierarchy(const std::shared_ptr<Folder>& ancestor,
+		std::optional<int> maxDepth,
+		const std::optional<std::vector<std::string>>& containerClasses);
+	// This doesn't cache the folders, so the walk can call it from any thread.
+	std::vector<std::shared_ptr<Folder>> ReadFolderRows(IMAPITable* pTable);
+
+	// Read the properties of a batch of objects. The columns and named properties are resolved
+	// once for the whole batch. With columns and a folder, the items are read from its restricted
+	// contents table, and anything which isn't there is opened one at a time on the store's
+	// strand. They can't be opened in parallel: every MAPI call on a store has to go through its
+	// strand, and the opened objects are cached, so they can't come from a thread which
+	// uninitializes MAPI when the batch is done. Batches for different stores still run
+	// concurrently on the executor's threads.
+	BatchProperties ReadBatchProperties(const std::vector<response::IdType>& ids,
+		const std::optional<std::vector<Column>>& columns, IMAPIFolder* pContents,
+		const std::function<CComPtr<IMAPIProp>(const response::IdType&)>& open);
+
+	// Read the folders which aren't cached yet from one CONVENIENT_DEPTH hierarchy table restricted
+	// to their entry IDs, and cache them under the IDs we asked for. OpenFolder still opens any
+	// which the provider can't find that way.
+	void CacheFolders(const std::vector<response::IdType>& folderIds);
 
 	// Utility methods to populate our cached special folder IDs from multiple properties on the
 	// store and folders.
 	static void FillInStoreProps(LPSPropValue storeIds, std::map<SpecialFolder, SBinary>& idMap);
 	static void FillInFolderProps(LPSPropValue folderIds, std::map<SpecialFolder, SBinary>& idMap);
+	static mapi_ptr<SPropValue> GetFolderIdProps(IMAPIFolder* folder);
 
+	// Guards the store, the IPM Subtree, the special folders and the notification dispatcher
+	// while they load. They don't change after that.
+	std::recursive_mutex m_openMutex;
 	CComPtr<IMsgStore> m_store;
 	response::IdType m_rootId;
 	CComPtr<IMAPIFolder> m_ipmSubtree;
@@ -490,14 +1172,16 @@ private:
 	mapi_ptr<SPropValue> m_inboxProps;
 	ULONG m_cbInboxId = 0;
 	mapi_ptr<ENTRYID> m_eidInboxId;
-	std::unique_ptr<std::vector<std::shared_ptr<Folder>>> m_rootFolders;
-	std::unique_ptr<std::map<response::IdType, size_t>> m_rootFolderIds;
-	CComPtr<AdviseSinkProxy<IMAPITable>> m_rootFolderSink;
-	service::Directives m_rootFolderDirectives;
+	SnapshotTable<response::IdType, Folder, std::string> m_rootFolders;
+	std::shared_ptr<ObjectNotificationDispatcher> m_notifications;
+	std::shared_ptr<ObjectNotificationDispatcher::Listener> m_rootFolderListener;
 	std::unique_ptr<std::map<SpecialFolder, response::IdType>> m_specialFolders;
+	std::mutex m_nameIdMutex;
 	NameIdToPropId m_nameIdToPropIds;
-	std::map<response::IdType, std::shared_ptr<Folder>> m_folderCache;
-	std::map<response::IdType, std::shared_ptr<Item>> m_itemCache;
+	ShardedCache<response::IdType, Folder, EntryIdHash> m_folderCache;
+	ShardedCache<response::IdType, Item, EntryIdHash> m_itemCache;
+	std::mutex m_queueMutex;
+	std::set<response::IdType> m_queuedFolderIds;
 };
 
 class Folder : public std::enable_shared_from_this<Folder>
@@ -550,28 +1234,29 @@ public:
 	int unread() const;
     bool hasSubfolders() const;
 	const CComPtr<IMAPIFolder>& folder();
-	const std::vector<std::shared_ptr<Folder>>& subFolders();
+	std::shared_ptr<const std::vector<std::shared_ptr<Folder>>> subFolders();
 	std::shared_ptr<Folder> parentFolder() const;
 	std::shared_ptr<Folder> lookupSubFolder(const response::IdType& id);
-	const std::vector<std::shared_ptr<Item>>& items();
+	std::shared_ptr<const std::vector<std::shared_ptr<Item>>> items();
 	std::shared_ptr<Item> lookupItem(const response::IdType& id);
+	std::vector<std::shared_ptr<object::Property>> changedColumns(const Folder& previous) const;
 
 	// Resolvers/Accessors which implement the GraphQL type
 	const response::IdType& getId() const;
-	std::shared_ptr<object::Folder> getParentFolder() const;
+	service::AwaitableObject<std::shared_ptr<object::Folder>> getParentFolder() const;
 	std::shared_ptr<object::Store> getStore() const;
 	const std::string& getName() const;
 	int getCount() const;
 	int getUnread() const;
     std::optional<std::string> getContainerClass() const;
-	std::optional<SpecialFolder> getSpecialFolder() const;
+	service::AwaitableScalar<std::optional<SpecialFolder>> getSpecialFolder();
 	std::vector<std::shared_ptr<object::Property>> getColumns() const;
-	std::vector<std::shared_ptr<object::Folder>> getSubFolders(
-		service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Folder>>> getSubFolders(
+		service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg);
 	std::vector<std::shared_ptr<object::Conversation>> getConversations(
 		service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg);
-	std::vector<std::shared_ptr<object::Item>> getItems(
-		service::FieldParams&& params, std::optional<std::vector<response::IdType>>&& idsArg);
+	service::AwaitableObject<std::vector<std::shared_ptr<object::Item>>> getItems(
+		service::FieldParams params, std::optional<std::vector<response::IdType>> idsArg);
 
 private:
 	// Used during construction
@@ -593,22 +1278,32 @@ private:
 	const int m_count;
 	const int m_unread;
     const bool m_hasSubfolders;
-	const std::optional<SpecialFolder> m_specialFolder;
 
 	// These lazy load and cache results between calls to const methods.
 	void OpenFolder();
-	void LoadSubFolders(service::Directives&& fieldDirectives);
-	void LoadItems(service::Directives&& fieldDirectives);
-
+	void LoadSpecialFolder();
+	std::shared_ptr<const FolderSnapshot> LoadSubFolders(
+		const service::Directives& fieldDirectives);
+	void ReadSubFolders(const TableDirectives& directives, FolderSnapshot& snapshot);
+	std::shared_ptr<const ItemSnapshot> LoadItems(const service::Directives& fieldDirectives);
+	void ReadItems(const TableDirectives& directives, ItemSnapshot& snapshot);
+
+	// Read just the requested rows from a restricted table, instead of looking for them in the
+	// current window. They come back in the order they were requested, and nullptr for any which
+	// aren't in this folder.
+	std::vector<std::shared_ptr<Folder>> LookupSubFolders(
+		const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids);
+	std::vector<std::shared_ptr<Item>> LookupItems(
+		const service::Directives& fieldDirectives, const std::vector<response::IdType>& ids);
+
+	// Guards the folder and special folder while they load.
+	std::mutex m_openMutex;
 	CComPtr<IMAPIFolder> m_folder;
-	std::unique_ptr<std::map<response::IdType, size_t>> m_subFolderIds;
-	std::unique_ptr<std::vector<std::shared_ptr<Folder>>> m_subFolders;
-	CComPtr<AdviseSinkProxy<IMAPITable>> m_subFolderSink;
-	service::Directives m_subFolderDirectives;
-	std::unique_ptr<std::map<response::IdType, size_t>> m_itemIds;
-	std::unique_ptr<std::vector<std::shared_ptr<Item>>> m_items;
-	CComPtr<AdviseSinkProxy<IMAPITable>> m_itemSink;
-	service::Directives m_itemDirectives;
+	std::unique_ptr<std::optional<SpecialFolder>> m_specialFolder;
+	SnapshotTable<response::IdType, Folder, std::string> m_subFolders;
+	std::shared_ptr<ObjectNotificationDispatcher::Listener> m_subFolderListener;
+	SnapshotTable<response::IdType, Item, std::string> m_items;
+	std::shared_ptr<ObjectNotificationDispatcher::Listener> m_itemListener;
 };
 
 class Item : public std::enable_shared_from_this<Item>
@@ -667,10 +1362,11 @@ public:
 	const FILETIME& modified() const;
 	const std::optional<std::string>& preview() const;
 	const CComPtr<IMessage>& message();
+	std::vector<std::shared_ptr<object::Property>> changedColumns(const Item& previous) const;
 
 	// Resolvers/Accessors which implement the GraphQL type
 	const response::IdType& getId() const;
-	std::shared_ptr<object::Folder> getParentFolder() const;
+	service::AwaitableObject<std::shared_ptr<object::Folder>> getParentFolder() const;
 	std::shared_ptr<object::Conversation> getConversation(service::FieldParams&& params) const;
 	const std::string& getSubject() const;
 	std::optional<std::string> getSender() const;
@@ -712,6 +1408,8 @@ private:
 	// These lazy load and cache results between calls to const methods.
 	void OpenItem();
 
+	// Guards the message while it opens.
+	std::mutex m_openMutex;
 	CComPtr<IMessage> m_message;
 };
 
@@ -868,13 +1566,15 @@ private:
 class ItemAdded
 {
 public:
-	explicit ItemAdded(int index, const std::shared_ptr<Item>& added);
+	explicit ItemAdded(int sequence, int index, const std::shared_ptr<Item>& added);
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	int getIndex() const;
 	std::shared_ptr<object::Item> getAdded() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const std::shared_ptr<Item> m_added;
 };
@@ -882,26 +1582,33 @@ private:
 class ItemUpdated
 {
 public:
-	explicit ItemUpdated(int index, const std::shared_ptr<Item>& updated);
+	explicit ItemUpdated(int sequence, int index, const std::shared_ptr<Item>& updated,
+		const std::shared_ptr<Item>& previous = {});
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	int getIndex() const;
 	std::shared_ptr<object::Item> getUpdated() const;
+	std::optional<std::vector<std::shared_ptr<object::Property>>> getChangedFields() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const std::shared_ptr<Item> m_updated;
+	const std::shared_ptr<Item> m_previous;
 };
 
 class ItemRemoved
 {
 public:
-	explicit ItemRemoved(int index, const response::IdType& removed);
+	explicit ItemRemoved(int sequence, int index, const response::IdType& removed);
 
+	int getSequence() const;
 	int getIndex() const;
 	const response::IdType& getRemoved() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const response::IdType m_removed;
 };
@@ -909,42 +1616,53 @@ private:
 class ItemsReloaded
 {
 public:
-	explicit ItemsReloaded(const std::vector<std::shared_ptr<Item>>& reloaded);
+	explicit ItemsReloaded(int sequence, const std::vector<std::shared_ptr<Item>>& reloaded);
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	std::vector<std::shared_ptr<object::Item>> getReloaded() const;
 
 private:
+	const int m_sequence;
 	const std::vector<std::shared_ptr<Item>> m_reloaded;
 };
 
 class ItemsSubscription
 {
 public:
-	explicit ItemsSubscription(std::vector<std::shared_ptr<object::ItemChange>>&& items);
+	explicit ItemsSubscription(std::vector<std::shared_ptr<object::ItemChange>>&& items,
+		std::optional<int> resumedFrom = std::nullopt);
 
 	// Resolvers/Accessors which implement the GraphQL type
-	std::vector<std::shared_ptr<object::ItemChange>> getItems(ObjectId&& folderIdArg) const;
+	std::vector<std::shared_ptr<object::ItemChange>> getItems(
+		service::FieldParams&& params, ObjectId&& folderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getSubFolders(
 		ObjectId&& parentFolderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getRootFolders(
 		response::IdType&& storeIdArg) const;
+	std::vector<std::shared_ptr<object::FolderCounts>> getFolderCounts(
+		std::vector<ObjectId>&& folderIdsArg) const;
 
 private:
 	// These are all initialized at construction.
 	std::vector<std::shared_ptr<object::ItemChange>> m_items;
+
+	// Only subscribers which @resume from this sequence should see a replay.
+	std::optional<int> m_resumedFrom;
 };
 
 class FolderAdded
 {
 public:
-	explicit FolderAdded(int index, const std::shared_ptr<Folder>& added);
+	explicit FolderAdded(int sequence, int index, const std::shared_ptr<Folder>& added);
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	int getIndex() const;
 	std::shared_ptr<object::Folder> getAdded() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const std::shared_ptr<Folder> m_added;
 };
@@ -952,27 +1670,34 @@ private:
 class FolderUpdated
 {
 public:
-	explicit FolderUpdated(int index, const std::shared_ptr<Folder>& updated);
+	explicit FolderUpdated(int sequence, int index, const std::shared_ptr<Folder>& updated,
+		const std::shared_ptr<Folder>& previous = {});
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	int getIndex() const;
 	std::shared_ptr<object::Folder> getUpdated() const;
+	std::optional<std::vector<std::shared_ptr<object::Property>>> getChangedFields() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const std::shared_ptr<Folder> m_updated;
+	const std::shared_ptr<Folder> m_previous;
 };
 
 class FolderRemoved
 {
 public:
-	explicit FolderRemoved(int index, const response::IdType& removed);
+	explicit FolderRemoved(int sequence, int index, const response::IdType& removed);
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	int getIndex() const;
 	const response::IdType& getRemoved() const;
 
 private:
+	const int m_sequence;
 	const int m_index;
 	const response::IdType m_removed;
 };
@@ -980,12 +1705,14 @@ private:
 class FoldersReloaded
 {
 public:
-	explicit FoldersReloaded(const std::vector<std::shared_ptr<Folder>>& reloaded);
+	explicit FoldersReloaded(int sequence, const std::vector<std::shared_ptr<Folder>>& reloaded);
 
 	// Resolvers/Accessors which implement the GraphQL type
+	int getSequence() const;
 	std::vector<std::shared_ptr<object::Folder>> getReloaded() const;
 
 private:
+	const int m_sequence;
 	const std::vector<std::shared_ptr<Folder>> m_reloaded;
 };
 
@@ -993,36 +1720,85 @@ class SubFoldersSubscription
 {
 public:
 	explicit SubFoldersSubscription(
-		std::vector<std::shared_ptr<object::FolderChange>>&& subFolders);
+		std::vector<std::shared_ptr<object::FolderChange>>&& subFolders,
+		std::optional<int> resumedFrom = std::nullopt);
 
 	// Resolvers/Accessors which implement the GraphQL type
 	std::vector<std::shared_ptr<object::ItemChange>> getItems(ObjectId&& folderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getSubFolders(
-		ObjectId&& parentFolderIdArg) const;
+		service::FieldParams&& params, ObjectId&& parentFolderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getRootFolders(
 		response::IdType&& storeIdArg) const;
+	std::vector<std::shared_ptr<object::FolderCounts>> getFolderCounts(
+		std::vector<ObjectId>&& folderIdsArg) const;
 
 private:
 	// These are all initialized at construction.
 	std::vector<std::shared_ptr<object::FolderChange>> m_subFolders;
+
+	// Only subscribers which @resume from this sequence should see a replay.
+	std::optional<int> m_resumedFrom;
 };
 
 class RootFoldersSubscription
 {
 public:
 	explicit RootFoldersSubscription(
-		std::vector<std::shared_ptr<object::FolderChange>>&& rootFolders);
+		std::vector<std::shared_ptr<object::FolderChange>>&& rootFolders,
+		std::optional<int> resumedFrom = std::nullopt);
 
 	// Resolvers/Accessors which implement the GraphQL type
 	std::vector<std::shared_ptr<object::ItemChange>> getItems(ObjectId&& folderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getSubFolders(
 		ObjectId&& parentFolderIdArg) const;
 	std::vector<std::shared_ptr<object::FolderChange>> getRootFolders(
-		response::IdType&& storeIdArg) const;
+		service::FieldParams&& params, response::IdType&& storeIdArg) const;
+	std::vector<std::shared_ptr<object::FolderCounts>> getFolderCounts(
+		std::vector<ObjectId>&& folderIdsArg) const;
 
 private:
 	// These are all initialized at construction.
 	std::vector<std::shared_ptr<object::FolderChange>> m_rootFolders;
+
+	// Only subscribers which @resume from this sequence should see a replay.
+	std::optional<int> m_resumedFrom;
+};
+
+class FolderCounts
+{
+public:
+	explicit FolderCounts(const ObjectId& folderId, int count, int unread);
+
+	// Resolvers/Accessors which implement the GraphQL type
+	const response::IdType& getStoreId() const;
+	const response::IdType& getFolderId() const;
+	int getCount() const;
+	int getUnread() const;
+
+private:
+	const ObjectId m_folderId;
+	const int m_count;
+	const int m_unread;
+};
+
+class FolderCountsSubscription
+{
+public:
+	explicit FolderCountsSubscription(
+		std::vector<std::shared_ptr<object::FolderCounts>>&& folderCounts);
+
+	// Resolvers/Accessors which implement the GraphQL type
+	std::vector<std::shared_ptr<object::ItemChange>> getItems(ObjectId&& folderIdArg) const;
+	std::vector<std::shared_ptr<object::FolderChange>> getSubFolders(
+		ObjectId&& parentFolderIdArg) const;
+	std::vector<std::shared_ptr<object::FolderChange>> getRootFolders(
+		response::IdType&& storeIdArg) const;
+	std::vector<std::shared_ptr<object::FolderCounts>> getFolderCounts(
+		std::vector<ObjectId>&& folderIdsArg) const;
+
+private:
+	// These are all initialized at construction.
+	std::vector<std::shared_ptr<object::FolderCounts>> m_folderCounts;
 };
 
 } // namespace graphql::mapi
\ No newline at end of file
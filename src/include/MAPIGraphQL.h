@@ -11,10 +11,43 @@
 #endif // !GQLMAPI_DLLEXPORTS
 // clang-format on
 
+#include "graphqlservice/GraphQLParse.h"
 #include "graphqlservice/GraphQLService.h"
 
+#include "ServiceOptions.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
 namespace graphql::mapi {
 
-GQLMAPI_IMPORT std::shared_ptr<service::Request> GetService(bool useDefaultProfile) noexcept;
+GQLMAPI_IMPORT std::shared_ptr<service::Request> GetService(
+	bool useDefaultProfile, const ServiceOptions& options = {}) noexcept;
+
+// Parse and validate a query, or return the AST which was already validated for the same query
+// text and operation name by any service in the process. The persisted query ID is optional, and
+// lets FindPersistedQuery return it later. It must be the lowercase hex SHA-256 digest of the query
+// text. Throws if the query is invalid or the ID doesn't match it. Other requests may resolve the
+// same AST concurrently, so don't modify it.
+GQLMAPI_IMPORT std::shared_ptr<peg::ast> ParseQuery(const service::Request& service,
+	std::string_view query, std::string_view operationName = {},
+	std::string_view persistedId = {});
+
+// Find a query by the persisted ID it was parsed with. Returns nullptr if it isn't cached, in
+// which case the client needs to send the query text again.
+GQLMAPI_IMPORT std::shared_ptr<peg::ast> FindPersistedQuery(
+	std::string_view persistedId, std::string_view operationName = {});
+
+// Resolve a request and serialize the response to JSON. If the service was created with a
+// ServiceOptions::responseCache capacity, repeated queries with the same text, operation name and
+// variables return the cached JSON without touching MAPI, as long as nothing they read changed.
+// Throws if the query is invalid, like ParseQuery.
+GQLMAPI_IMPORT std::string ResolveToJSON(const std::shared_ptr<service::Request>& service,
+	std::string_view query, std::string_view operationName = {},
+	const response::Value& variables = response::Value { response::Type::Map });
+
+GQLMAPI_IMPORT void ConfigureQueryCache(const QueryCacheOptions& options);
+GQLMAPI_IMPORT std::shared_ptr<const QueryCacheMetrics> GetQueryCacheMetrics() noexcept;
 
 } // namespace graphql::mapi
\ No newline at end of file
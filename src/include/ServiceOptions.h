@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace graphql::mapi {
+
+// What to do when a MAPI notification thread finds the subscription notification queue full.
+enum class QueueFullPolicy
+{
+	// Drop the notifications, and reload the table once a worker catches up with it.
+	DropToReload,
+
+	// Block the MAPI notification thread until there is room in the queue.
+	Block,
+};
+
+// Counters which the subscription notification queue updates, to monitor backpressure.
+struct NotificationQueueMetrics
+{
+	// Batches of notifications which were queued for the workers.
+	std::atomic<size_t> queued { 0 };
+
+	// Batches the workers finished translating and delivering.
+	std::atomic<size_t> processed { 0 };
+
+	// Batches which were dropped because the queue was full or a reload was already queued.
+	std::atomic<size_t> dropped { 0 };
+
+	// Table reloads which were queued in place of dropped batches.
+	std::atomic<size_t> reloads { 0 };
+
+	// Times a MAPI notification thread had to wait for room in the queue.
+	std::atomic<size_t> blocked { 0 };
+
+	// Current and highest number of batches waiting for a worker.
+	std::atomic<size_t> depth { 0 };
+	std::atomic<size_t> maxDepth { 0 };
+};
+
+// Controls how table notifications are delivered to subscriptions.
+struct SubscriptionOptions
+{
+	// Collect the notifications for each subscription for this long (e.g. 20ms) before delivering
+	// a single payload with the net changes. Zero delivers each batch from MAPI as it arrives.
+	std::chrono::milliseconds coalesceWindow { 0 };
+
+	// Deliver before the window closes once this many notifications are pending. Zero only
+	// delivers when the window closes.
+	size_t coalesceThreshold { 0 };
+
+	// When MAPI asks us to reload a table, deliver the Added/Removed/Updated changes compared to
+	// the window we already had, unless there are more than this many. Past the threshold it's
+	// cheaper to deliver the whole window in a single Reloaded event. Zero always does that if
+	// anything changed.
+	size_t reloadDiffThreshold { 20 };
+
+	// Number of worker threads which translate and deliver table notifications, so the MAPI
+	// notification threads only need to copy them. Zero handles them on the MAPI notification
+	// thread.
+	size_t dispatchThreads { 1 };
+
+	// Maximum number of notification batches waiting for a worker.
+	size_t dispatchQueueCapacity { 256 };
+	QueueFullPolicy queueFullPolicy { QueueFullPolicy::DropToReload };
+
+	// Optionally share the counters with the caller.
+	std::shared_ptr<NotificationQueueMetrics> queueMetrics;
+
+	// Number of delivered changes each subscribed table remembers, so a subscriber which
+	// reconnects with @resume only gets the changes it missed. Resuming from anything older
+	// delivers the whole window instead. Zero disables the history.
+	size_t resumeHistory { 256 };
+
+	// Number of subscribed tables which are retained after their last subscriber leaves, so that
+	// subscribers which reconnect can still @resume. They stop listening to MAPI, and the changes
+	// they missed are computed from a reload when the next subscriber arrives.
+	size_t retainedSinks { 16 };
+
+	// Deliver folderCounts changes for each folder at most once per interval, with the latest
+	// counts when it elapses. Zero delivers every change as soon as it's read.
+	std::chrono::milliseconds folderCountsInterval { 250 };
+};
+
+// Controls how Store.folderHierarchy walks the folders.
+struct HierarchyOptions
+{
+	// Number of threads which expand subtrees concurrently when the provider doesn't support
+	// CONVENIENT_DEPTH hierarchy tables, including the thread which resolves the field. One or
+	// zero walks the hierarchy on that thread alone.
+	size_t walkThreads { 4 };
+};
+
+// Controls how many windows of each table are cached.
+struct TableCacheOptions
+{
+	// Number of windows each table keeps, keyed by their table directives, so requests which
+	// alternate between different @take or @orderBy views of the same table don't reload it every
+	// time. One only keeps the latest window.
+	size_t windows { 4 };
+};
+
+// Controls how the resolvers for each store are scheduled.
+struct ExecutorOptions
+{
+	// Number of worker threads which run the MAPI calls for the stores. Calls for the same store
+	// run one at a time and in order, while different stores run concurrently. Zero makes the
+	// calls on the thread which resolves the field.
+	size_t storeThreads { 4 };
+};
+
+// How much GetService loads on a background thread before the first request needs it. Requests
+// which arrive before it's done wait for it instead of loading the same objects again.
+enum class WarmUpPolicy
+{
+	// Load everything on demand.
+	None,
+
+	// Read the message stores table and open each store.
+	Stores,
+
+	// Also load the root folders and special folders in each store.
+	Folders,
+};
+
+// Counters for the cache of parsed and validated queries which every service in the process shares.
+struct QueryCacheMetrics
+{
+	// Queries which were found in the cache, or which had to be parsed and validated.
+	std::atomic<size_t> hits { 0 };
+	std::atomic<size_t> misses { 0 };
+
+	// Persisted query IDs which were found, or which the client has to send the query text for.
+	std::atomic<size_t> persistedHits { 0 };
+	std::atomic<size_t> persistedMisses { 0 };
+
+	// Queries which were dropped to make room for more recent ones.
+	std::atomic<size_t> evictions { 0 };
+};
+
+// Settings for the cache of parsed and validated queries, which can be passed to
+// ConfigureQueryCache.
+struct QueryCacheOptions
+{
+	// Number of queries to keep, with the least recently used dropped first. Zero disables the
+	// cache.
+	size_t capacity { 256 };
+};
+
+// Counters for the response cache of a service, to monitor the hit rate.
+struct ResponseCacheMetrics
+{
+	// Responses which were returned from the cache, or which weren't cached yet.
+	std::atomic<size_t> hits { 0 };
+	std::atomic<size_t> misses { 0 };
+
+	// Cached responses which had to be resolved again because something they read changed.
+	std::atomic<size_t> stale { 0 };
+};
+
+// Controls the opt-in cache of serialized responses for ResolveToJSON.
+struct ResponseCacheOptions
+{
+	// Number of query responses to keep, with the least recently used dropped first. Zero
+	// disables the cache.
+	size_t capacity { 0 };
+
+	// Optionally share the counters with the caller.
+	std::shared_ptr<ResponseCacheMetrics> metrics;
+};
+
+// Optional settings which can be passed to GetService.
+//
+// Services which log on to the same profile share each store and its folder and item caches. The
+// shared store keeps the MAPI session, hierarchy, tables, and executor settings of the service
+// which opened it first, and ignores those settings from the services which share it later, until
+// the stores table row changes or every service which used it is released. That service is also
+// the one which clears the shared caches at the end of each query, and mutations in any service
+// clear them too.
+struct ServiceOptions
+{
+	SubscriptionOptions subscriptions {};
+	HierarchyOptions hierarchy {};
+	TableCacheOptions tables {};
+	ExecutorOptions executor {};
+	ResponseCacheOptions responseCache {};
+	WarmUpPolicy warmUp { WarmUpPolicy::None };
+};
+
+} // namespace graphql::mapi
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+
+#include "ConcurrentCache.h"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace graphql::mapi;
+
+namespace {
+
+struct Row
+{
+	int value;
+
+	int id() const noexcept
+	{
+		return value;
+	}
+};
+
+using RowSnapshot = TableSnapshot<int, Row>;
+using RowTable = SnapshotTable<int, Row, int>;
+
+constexpr size_t c_threadCount = 8;
+constexpr size_t c_iterations = 2000;
+constexpr int c_rowCount = 50;
+
+void FillRows(RowSnapshot& snapshot, int offset = 0)
+{
+	for (int i = 0; i < c_rowCount; ++i)
+	{
+		snapshot.append(std::make_shared<Row>(Row { offset + i }));
+	}
+}
+
+void RunThreads(const std::function<void(size_t)>& body)
+{
+	std::vector<std::thread> threads;
+
+	threads.reserve(c_threadCount);
+	for (size_t i = 0; i < c_threadCount; ++i)
+	{
+		threads.emplace_back(body, i);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+} // namespace
+
+TEST(ConcurrentCache, SnapshotLoadsOnce)
+{
+	RowTable table;
+	std::atomic<size_t> loads { 0 };
+	std::vector<std::shared_ptr<const RowSnapshot>> snapshots(c_threadCount);
+
+	RunThreads([&](size_t index) {
+		for (size_t i = 0; i < c_iterations; ++i)
+		{
+			snapshots[index] = table.load(0, [&loads](RowSnapshot& snapshot) {
+				++loads;
+				std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+				FillRows(snapshot);
+			});
+		}
+	});
+
+	EXPECT_EQ(size_t { 1 }, loads.load()) << "should only load the table once";
+
+	for (const auto& snapshot : snapshots)
+	{
+		EXPECT_EQ(snapshots.front(), snapshot) << "should share the same snapshot";
+	}
+}
+
+TEST(ConcurrentCache, SnapshotReloadsWhenDirectivesChange)
+{
+	RowTable table;
+	size_t loads = 0;
+	const auto loader = [&loads](RowSnapshot& snapshot) {
+		++loads;
+		FillRows(snapshot);
+	};
+
+	const auto first = table.load(1, loader);
+	const auto second = table.load(2, loader);
+	const auto third = table.load(2, loader);
+
+	EXPECT_EQ(size_t { 2 }, loads) << "should load the table again for different directives";
+	EXPECT_NE(first, second) << "should replace the snapshot";
+	EXPECT_EQ(second, third) << "should reuse the snapshot for the same directives";
+	EXPECT_EQ(size_t { c_rowCount }, first->rows.size()) << "should keep the first snapshot";
+}
+
+TEST(ConcurrentCache, SnapshotKeepsAlternatingWindows)
+{
+	RowTable table { 2 };
+	size_t loads = 0;
+	const auto loader = [&loads](RowSnapshot& snapshot) {
+		++loads;
+		FillRows(snapshot);
+	};
+
+	const auto first = table.load(1, loader);
+	const auto second = table.load(2, loader);
+
+	EXPECT_EQ(first, table.load(1, loader)) << "should keep the first window";
+	EXPECT_EQ(second, table.load(2, loader)) << "should keep the second window";
+	EXPECT_EQ(size_t { 2 }, loads) << "should only load each window once";
+	EXPECT_EQ(second, table.current()) << "should make the last one loaded current";
+}
+
+TEST(ConcurrentCache, SnapshotEvictsLeastRecentlyUsed)
+{
+	RowTable table { 2 };
+	size_t loads = 0;
+	const auto loader = [&loads](RowSnapshot& snapshot) {
+		++loads;
+		FillRows(snapshot);
+	};
+
+	table.load(1, loader);
+	table.load(2, loader);
+	table.load(1, loader);
+	table.load(3, loader);
+
+	EXPECT_EQ(size_t { 3 }, loads);
+	EXPECT_EQ(size_t { 2 }, table.snapshots().size()) << "should only keep two windows";
+
+	table.load(1, loader);
+	EXPECT_EQ(size_t { 3 }, loads) << "should keep the recently used window";
+
+	table.load(2, loader);
+	EXPECT_EQ(size_t { 4 }, loads) << "should load the evicted window again";
+}
+
+TEST(ConcurrentCache, SnapshotResetDropsAllWindows)
+{
+	RowTable table { 2 };
+	size_t loads = 0;
+	const auto loader = [&loads](RowSnapshot& snapshot) {
+		++loads;
+		FillRows(snapshot);
+	};
+
+	table.load(1, loader);
+	table.load(2, loader);
+	table.reset();
+
+	EXPECT_EQ(nullptr, table.current()) << "should not have a current window";
+	EXPECT_TRUE(table.snapshots().empty()) << "should drop every window";
+
+	table.load(1, loader);
+	table.load(2, loader);
+	EXPECT_EQ(size_t { 4 }, loads) << "should load both windows again";
+}
+
+TEST(ConcurrentCache, SnapshotResetWhileReading)
+{
+	RowTable table;
+	std::atomic<size_t> loads { 0 };
+	std::atomic<size_t> inconsistent { 0 };
+	std::atomic<bool> done { false };
+
+	std::thread resetter { [&table, &done]() {
+		while (!done)
+		{
+			table.reset();
+			std::this_thread::yield();
+		}
+	} };
+
+	RunThreads([&](size_t) {
+		for (size_t i = 0; i < c_iterations; ++i)
+		{
+			const auto snapshot = table.load(0, [&loads](RowSnapshot& snapshot) {
+				FillRows(snapshot, static_cast<int>(++loads) * c_rowCount);
+			});
+
+			// The rows must not change underneath us, even if the snapshot is reset.
+			if (snapshot->rows.size() != static_cast<size_t>(c_rowCount)
+				|| snapshot->ids.size() != snapshot->rows.size())
+			{
+				++inconsistent;
+				continue;
+			}
+
+			for (const auto& row : snapshot->rows)
+			{
+				if (snapshot->find(row->id()) != row)
+				{
+					++inconsistent;
+					break;
+				}
+			}
+		}
+	});
+
+	done = true;
+	resetter.join();
+
+	EXPECT_EQ(size_t { 0 }, inconsistent.load()) << "should always read a complete snapshot";
+	EXPECT_LT(size_t { 1 }, loads.load()) << "should load the table again after a reset";
+}
+
+TEST(ConcurrentCache, ShardedCacheFirstInsertWins)
+{
+	ShardedCache<int, Row, std::hash<int>> cache;
+	std::vector<std::vector<std::shared_ptr<Row>>> winners(c_threadCount);
+
+	RunThreads([&](size_t index) {
+		auto& cached = winners[index];
+
+		cached.reserve(c_iterations);
+		for (size_t i = 0; i < c_iterations; ++i)
+		{
+			const auto key = static_cast<int>(i);
+
+			cached.push_back(cache.insert(key, std::make_shared<Row>(Row { key })));
+		}
+	});
+
+	for (size_t i = 0; i < c_iterations; ++i)
+	{
+		const auto key = static_cast<int>(i);
+		const auto expected = cache.find(key);
+
+		ASSERT_NE(nullptr, expected) << "should find every key";
+
+		for (const auto& cached : winners)
+		{
+			EXPECT_EQ(expected, cached[i]) << "should return the first value for every key";
+		}
+	}
+}
+
+TEST(ConcurrentCache, ShardedCacheClearWhileReading)
+{
+	ShardedCache<int, Row, std::hash<int>> cache;
+	std::atomic<size_t> mismatched { 0 };
+
+	RunThreads([&](size_t index) {
+		for (size_t i = 0; i < c_iterations; ++i)
+		{
+			const auto key = static_cast<int>(i % 64);
+
+			if (index == 0 && i % 100 == 0)
+			{
+				cache.clear();
+			}
+
+			const auto cached = cache.insert(key, std::make_shared<Row>(Row { key }));
+			const auto found = cache.find(key);
+
+			if (cached->id() != key || (found && found->id() != key))
+			{
+				++mismatched;
+			}
+		}
+	});
+
+	EXPECT_EQ(size_t { 0 }, mismatched.load()) << "should only find values for the same key";
+}
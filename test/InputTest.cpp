@@ -22,6 +22,18 @@ response::IdType getByteData() noexcept
 	return result;
 }
 
+response::IdType getOtherByteData() noexcept
+{
+	using namespace std::literals;
+
+	const auto otherIdString = "otherId"sv;
+	response::IdType result(otherIdString.size());
+
+	std::copy(otherIdString.begin(), otherIdString.end(), result.begin());
+
+	return result;
+}
+
 response::IdType getOpaqueString() noexcept
 {
 	return response::IdType { getByteData().release<response::IdType::OpaqueString>() };
@@ -51,3 +63,42 @@ TEST(ConvertInput, FromIdTypeOpaqueString)
 		actual.release<response::IdType::ByteData>())
 		<< "converted value should match";
 }
+
+TEST(ConvertInput, MatchesIdTypeArgument)
+{
+	const auto expected = getByteData();
+
+	EXPECT_TRUE(matches_input(response::Value { getByteData() }, expected))
+		<< "should match the bytes";
+	EXPECT_TRUE(matches_input(
+		response::Value { getByteData().release<response::IdType::OpaqueString>() },
+		expected))
+		<< "should match the base64 string";
+	EXPECT_FALSE(matches_input(
+		response::Value { getOtherByteData().release<response::IdType::OpaqueString>() },
+		expected))
+		<< "should not match another ID";
+	EXPECT_FALSE(matches_input(response::Value { 5 }, expected)) << "should not match an Int";
+}
+
+TEST(ConvertInput, MatchesObjectIdArgument)
+{
+	const mapi::ObjectId expected { getByteData(), getOtherByteData() };
+	response::Value sameSink { response::Type::Map };
+
+	// Clients can list the fields in any order.
+	sameSink.emplace_back("objectId",
+		response::Value { getOtherByteData().release<response::IdType::OpaqueString>() });
+	sameSink.emplace_back("storeId", response::Value { getByteData() });
+
+	response::Value otherSink { response::Type::Map };
+
+	otherSink.emplace_back("storeId", response::Value { getByteData() });
+	otherSink.emplace_back("objectId", response::Value { getByteData() });
+
+	EXPECT_TRUE(matches_input(sameSink, expected)) << "should match the same folder";
+	EXPECT_FALSE(matches_input(otherSink, expected))
+		<< "should not match subscribers on another folder";
+	EXPECT_FALSE(matches_input(response::Value { getByteData() }, expected))
+		<< "should not match a bare ID";
+}
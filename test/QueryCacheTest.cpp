@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+
+#include "MockObjects.h"
+
+#include "QueryCache.h"
+#include "QueryObject.h"
+
+using namespace graphql;
+using namespace graphql::mapi;
+
+using namespace Mock;
+
+namespace {
+
+constexpr std::string_view c_storesQuery = R"gql(query Stores { stores { name } })gql";
+constexpr std::string_view c_storeIdsQuery = R"gql(query StoreIds { stores { id } })gql";
+constexpr std::string_view c_rootFoldersQuery =
+	R"gql(query RootFolders { stores { rootFolders { name } } })gql";
+
+// The lowercase hex SHA-256 digests of c_storesQuery and c_storeIdsQuery.
+constexpr std::string_view c_storesId =
+	"f5e117d621aad6fa73e4d9aabae07dae9bd1d086792629079439aae08ae3a90f";
+constexpr std::string_view c_storeIdsId =
+	"39d584c5a2ae5bf6a9368d89c7e7665995fb15a5fd7adf7321ac4c7e4d0a1fbf";
+
+std::shared_ptr<service::Request> MakeService()
+{
+	return std::make_shared<Operations>(
+		std::make_shared<object::Query>(std::make_shared<MockQuery>()),
+		std::shared_ptr<object::Mutation> {},
+		std::shared_ptr<object::Subscription> {});
+}
+
+} // namespace
+
+TEST(QueryCache, ParsesOnce)
+{
+	QueryCache cache;
+	const auto service = MakeService();
+
+	const auto first = cache.parse(*service, c_storesQuery, "Stores");
+	const auto second = cache.parse(*service, c_storesQuery, "Stores");
+	const auto metrics = cache.metrics();
+
+	ASSERT_NE(nullptr, first);
+	EXPECT_TRUE(first->validated) << "should validate the query";
+	EXPECT_EQ(first, second) << "should reuse the cached AST";
+	EXPECT_EQ(size_t { 1 }, metrics->hits.load());
+	EXPECT_EQ(size_t { 1 }, metrics->misses.load());
+}
+
+TEST(QueryCache, SharedAcrossServices)
+{
+	QueryCache cache;
+
+	const auto first = cache.parse(*MakeService(), c_storesQuery, "Stores");
+	const auto second = cache.parse(*MakeService(), c_storesQuery, "Stores");
+
+	EXPECT_EQ(first, second) << "should reuse the AST for another service";
+}
+
+TEST(QueryCache, KeyedByOperationName)
+{
+	QueryCache cache;
+	const auto service = MakeService();
+
+	const auto named = cache.parse(*service, c_storesQuery, "Stores");
+	const auto unnamed = cache.parse(*service, c_storesQuery, {});
+
+	EXPECT_NE(named, unnamed) << "should cache each operation name separately";
+	EXPECT_EQ(size_t { 2 }, cache.metrics()->misses.load());
+}
+
+TEST(QueryCache, InvalidQueryNotCached)
+{
+	QueryCache cache;
+	const auto service = MakeService();
+	constexpr std::string_view invalidQuery = R"gql({ missingField })gql";
+
+	EXPECT_THROW(cache.parse(*service, invalidQuery, {}), service::schema_exception);
+	EXPECT_THROW(cache.parse(*service, invalidQuery, {}), service::schema_exception);
+	EXPECT_EQ(size_t { 0 }, cache.metrics()->hits.load()) << "should validate it every time";
+	EXPECT_EQ(size_t { 2 }, cache.metrics()->misses.load());
+}
+
+TEST(QueryCache, PersistedQuery)
+{
+	QueryCache cache;
+	const auto service = MakeService();
+
+	EXPECT_EQ(nullptr, cache.find(c_storesId, "Stores")) << "should not know the ID yet";
+
+	const auto parsed = cache.parse(*service, c_storesQuery, "Stores", c_storesId);
+	const auto found = cache.find(c_storesId, "Stores");
+	const auto metrics = cache.metrics();
+
+	EXPECT_EQ(parsed, found) << "should find the query by its persisted ID";
+	EXPECT_EQ(nullptr, cache.find(c_storesId, "Other")) << "should match the operation name";
+	EXPECT_EQ(size_t { 1 }, metrics->persistedHits.load());
+	EXPECT_EQ(size_t { 2 }, metrics->persistedMisses.load());
+}
+
+TEST(QueryCache, RejectsMismatchedPersistedId)
+{
+	QueryCache cache;
+	const auto service = MakeService();
+
+	cache.parse(*service, c_storesQuery, "Stores", c_storesId);
+
+	EXPECT_THROW(cache.parse(*service, c_storeIdsQuery, "Stores", c_storesId),
+		service::schema_exception)
+		<< "should not rebind the ID to another query";
+	EXPECT_THROW(cache.parse(*service, c_storeIdsQuery, "StoreIds", "storeIds"),
+		service::schema_exception)
+		<< "should reject an ID which is not the digest of the query";
+	EXPECT_EQ(nullptr, cache.find("storeIds", "StoreIds")) << "should not persist the bad ID";
+
+	const auto found = cache.find(c_storesId, "Stores");
+
+	ASSERT_NE(nullptr, found);
+	EXPECT_EQ(cache.parse(*service, c_storesQuery, "Stores"), found)
+		<< "should keep the ID bound to the original query";
+}
+
+TEST(QueryCache, EvictsLeastRecentlyUsed)
+{
+	QueryCache cache { 2 };
+	const auto service = MakeService();
+
+	const auto stores = cache.parse(*service, c_storesQuery, "Stores", c_storesId);
+	const auto storeIds = cache.parse(*service, c_storeIdsQuery, "StoreIds", c_storeIdsId);
+
+	EXPECT_EQ(stores, cache.find(c_storesId, "Stores")) << "should make it the most recent";
+
+	cache.parse(*service, c_rootFoldersQuery, "RootFolders");
+
+	EXPECT_EQ(stores, cache.find(c_storesId, "Stores")) << "should keep the recent query";
+	EXPECT_EQ(nullptr, cache.find(c_storeIdsId, "StoreIds")) << "should evict the oldest query";
+	EXPECT_EQ(size_t { 1 }, cache.metrics()->evictions.load());
+	EXPECT_NE(storeIds, cache.parse(*service, c_storeIdsQuery, "StoreIds"))
+		<< "should parse the evicted query again";
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+
+#include "Types.h"
+
+using namespace graphql;
+using namespace graphql::mapi;
+
+TEST(ResponseCache, CachesStoreReads)
+{
+	const auto ast =
+		peg::parseString(R"gql(query Stores { stores { name rootFolders { id } } })gql");
+
+	EXPECT_TRUE(ResponseCache::ReadsOnlyStores(ast)) << "should cache responses from the stores";
+}
+
+TEST(ResponseCache, SkipsMsgFileData)
+{
+	const auto ast = peg::parseString(R"gql(query File {
+			stores { name }
+			file: msgFileData(filepath: "mail.msg", props: []) { __typename }
+		})gql");
+
+	EXPECT_FALSE(ResponseCache::ReadsOnlyStores(ast))
+		<< "should not cache a response which read a .msg file";
+}
+
+TEST(ResponseCache, SkipsMsgFileDataInFragments)
+{
+	const auto ast = peg::parseString(R"gql(query File { ...FileFields }
+		fragment FileFields on Query {
+			msgFileData(filepath: "mail.msg", props: []) { __typename }
+		})gql");
+
+	EXPECT_FALSE(ResponseCache::ReadsOnlyStores(ast))
+		<< "should find msgFileData in a fragment";
+}
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gtest/gtest.h>
+
+#include "Sha256.h"
+
+#include <string>
+
+using namespace convert::sha256;
+
+TEST(ConvertSha256, Empty)
+{
+	const auto actual = to_hex({});
+
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", actual)
+		<< "should hash the empty string";
+}
+
+TEST(ConvertSha256, ToHex)
+{
+	const auto actual = to_hex("abc");
+
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", actual)
+		<< "should convert to the expected digest";
+}
+
+TEST(ConvertSha256, PaddingBlock)
+{
+	const auto actual = to_hex(std::string(56, 'a'));
+
+	EXPECT_EQ("b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a", actual)
+		<< "should pad the length into another block";
+}
+
+TEST(ConvertSha256, MultipleBlocks)
+{
+	const auto actual = to_hex(std::string(1000, 'x'));
+
+	EXPECT_EQ("44f8354494a5ba03ba1792a8d3e9c534c47a9181980fde7a3f44b06ef2ae7c7f", actual)
+		<< "should hash every block";
+}